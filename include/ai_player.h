@@ -7,6 +7,7 @@
 #include "spectre/move_generator.h"
 #include "spectre/spy.h"
 #include "spectre/profiler.h"
+#include "spectre/anytime.h"
 #include <vector>
 #include <string>
 
@@ -18,7 +19,13 @@ enum class AIStyle {
 
 class AIPlayer : public PlayerController {
 public:
-    AIPlayer(AIStyle style);
+    // Cutie_Pi's searches (midgame and endgame) get 'moveTimeMs' per move
+    static constexpr int DEFAULT_MOVE_TIME_MS = 3000;
+
+    AIPlayer(AIStyle style, int moveTimeMs = DEFAULT_MOVE_TIME_MS);
+
+    void setMoveTime(int ms) { moveTimeMs = ms; }
+    int getMoveTime() const { return moveTimeMs; }
 
     // FIX: Updated to match PlayerController's new signature
     Move getMove(const GameState& state,
@@ -32,12 +39,14 @@ public:
 
     // Hook for observing moves (Used by Cutie_Pi/Spy)
     // Note: This is not in PlayerController, it is specific to AIPlayer.
-    void observeMove(const Move& move, const LetterBoard& board);
+    void observeMove(const Move& move, const LetterBoard& board, const BlankBoard& blanks);
 
     std::string getName() const override;
 
 private:
     AIStyle style;
+    int moveTimeMs;
+    spectre::AnytimeSearch thinking;
     spectre::Spy spy;
     spectre::Profiler profiler;
     std::vector<spectre::MoveCandidate> candidates;
@@ -21,10 +21,11 @@ public:
         bool verbose;
         bool allowChallenge;
         bool sixPassEndsGame;
+        bool strictDictionary; // Referee rejects phonies outright (see Referee::checkWords)
         int delayMs;
 
         // Explicit Constructor to fix compiler error
-        Config() : verbose(true), allowChallenge(true), sixPassEndsGame(true), delayMs(0) {}
+        Config() : verbose(true), allowChallenge(true), sixPassEndsGame(true), strictDictionary(false), delayMs(0) {}
     };
 
     GameDirector(PlayerController* p1, PlayerController* p2,
@@ -40,7 +41,7 @@ private:
 
     // Internal State
     GameState state;
-    GameState snapshot;
+    MoveUndo lastUndo;      // Only recorded when challenges are allowed
     LastMoveInfo lastMove;
     bool canChallenge;
 
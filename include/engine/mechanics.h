@@ -6,13 +6,18 @@
 
 namespace Mechanics {
     // Applies a validated move to the state (Updates Board, Rack, Score, Bag)
-    void applyMove(GameState& state, const Move& move, int score);
+    // If 'undo' is given, it records what changed so undoMove can take it back.
+    void applyMove(GameState& state, const Move& move, int score, MoveUndo* undo = nullptr);
 
-    // Saves the current state into a backup
-    void commitSnapshot(GameState& backup, const GameState& current);
+    // Reverts a move recorded by applyMove (must be the most recent change to the state)
+    void undoMove(GameState& state, const MoveUndo& undo);
 
-    // Restores the game state from a backup (Used in challenges)
-    void restoreSnapshot(GameState& current, const GameState& backup);
+    // Hands the turn to 'playerIdx' (keeps the side-to-move hash in sync)
+    void setCurrentPlayer(GameState& state, int playerIdx);
+
+    // Recomputes both players' unseen-tile histograms from scratch
+    // (game start, or after editing the state directly)
+    void rebuildUnseen(GameState& state);
 
     // Attempts an exchange (Updates Rack, Bag, PassCount) - Returns true if successful
     bool attemptExchange(GameState& state, const Move& move);
@@ -23,5 +28,12 @@ namespace Mechanics {
     // Player who finishes first gets bonus (twice the value of remaining tiles of opponent)
     void applyEmptyRackBonus(GameState& state, int winnerIdx);
 
-    int calculateTrueScore(const spectre::MoveCandidate &move, const LetterBoard& letters, const Board &bonusBoard);
+    // Copy of the board with blank tiles in lowercase: the search-board form
+    // the move generator, Spy, Vanguard and Judge score without a BlankBoard
+    LetterBoard searchBoard(const LetterBoard& letters, const BlankBoard& blanks);
+
+    // Score of a generated move via the shared Scoring kernel.
+    // Pass 'blanks' for the live game board; search boards mark blanks in lowercase instead.
+    int calculateTrueScore(const spectre::MoveCandidate &move, const LetterBoard& letters,
+                           const BlankBoard* blanks = nullptr);
 }
\ No newline at end of file
@@ -11,6 +11,9 @@ using namespace std;
 // returns how many tiles were actually drawn
 int drawTiles(TileBag &bag, TileRack &rack, int count);
 
+// Build a rack from a 27-slot histogram (A-Z, '?'), tiles in letter order
+TileRack rackFromCounts(const int *counts);
+
 //Print the rack like 1:A(1) 2:T(1) 3:Q(10)
 void printRack(const TileRack &rack);
 
@@ -4,12 +4,19 @@
 #include "types.h"
 #include "state.h"
 #include "dictionary.h"
+#include "scoring.h"
 
 class Referee {
 public:
 
     // The core function: Input State + Move -> Output Result
-    static MoveResult validateMove(const GameState &state, const Move &move, const Board &bonusBoard, Dictionary &dict);
+    // 'strictDictionary' also rejects moves that form any word not in 'dict'.
+    static MoveResult validateMove(const GameState &state, const Move &move, Dictionary &dict,
+                                   bool strictDictionary = false);
+
+    // Fast legality check of every word a placement forms, without building strings:
+    // one GADDAG walk for the main word and one for each cross word.
+    static bool checkWords(const LetterBoard &letters, const Scoring::Placement &placement, const Dictionary &dict);
 
     // Helpers
     static int calculateScore(const LetterBoard &letters, const Board &bonuses, const Move &move);
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "types.h"
+
+using namespace std;
+
+// ================================================================
+//                     THE SCORING KERNEL
+// ================================================================
+// One table set and one scoring function shared by the Referee,
+// Mechanics and every Spectre module. Everything below is built at
+// compile time, so there is no runtime board setup.
+namespace Scoring {
+
+    constexpr int BINGO_SIZE = 7;
+    constexpr int BINGO_BONUS = 50;
+
+    // Letter -> points, indexed by the raw char.
+    // Lowercase letters are blanks standing in for a letter and '?' is an
+    // unassigned blank, so both of them are worth 0.
+    constexpr array<uint8_t, 256> buildLetterValues() {
+        array<uint8_t, 256> values{};
+        constexpr uint8_t upper[26] = {
+            1, 3, 3, 2, 1, 4, 2, 4, 1, 8, 5, 1, 3, 1, 1, 3, 10, 1, 1, 1, 1, 4, 4, 8, 4, 10
+        };
+        for (int i = 0; i < 26; i++) values['A' + i] = upper[i];
+        return values;
+    }
+
+    inline constexpr array<uint8_t, 256> LETTER_VALUES = buildLetterValues();
+
+    constexpr int letterValue(char ch) {
+        return LETTER_VALUES[static_cast<unsigned char>(ch)];
+    }
+
+    // Official Scrabble Bonus Layout
+    // (Row = A–O → 0–14, Col = 1–15 → 0–14)
+    constexpr Board buildBonusBoard() {
+        Board board{};
+        for (auto &row : board) row.fill(CellType::Normal);
+
+        constexpr int tws[][2] = {
+            {0,0},{0,7},{0,14},
+            {7,0},{7,14},
+            {14,0},{14,7},{14,14}
+        };
+        constexpr int dws[][2] = {
+            {1,1},{2,2},{3,3},{4,4},{7,7},
+            {10,10},{11,11},{12,12},{13,13},
+            {1,13},{2,12},{3,11},{4,10},
+            {10,4},{11,3},{12,2},{13,1}
+        };
+        constexpr int tls[][2] = {
+            {1,5},{1,9},
+            {5,1},{5,5},{5,9},{5,13},
+            {9,1},{9,5},{9,9},{9,13},
+            {13,5},{13,9}
+        };
+        constexpr int dls[][2] = {
+            {0,3},{0,11},
+            {2,6},{2,8},
+            {3,0},{3,7},{3,14},
+            {6,2},{6,6},{6,8},{6,12},
+            {7,3},{7,11},
+            {8,2},{8,6},{8,8},{8,12},
+            {11,0},{11,7},{11,14},
+            {12,6},{12,8},
+            {14,3},{14,11}
+        };
+
+        for (auto &p : tws) board[p[0]][p[1]] = CellType::TWS;
+        for (auto &p : dws) board[p[0]][p[1]] = CellType::DWS;
+        for (auto &p : tls) board[p[0]][p[1]] = CellType::TLS;
+        for (auto &p : dls) board[p[0]][p[1]] = CellType::DLS;
+        return board;
+    }
+
+    inline constexpr Board BONUS_BOARD = buildBonusBoard();
+
+    using MultiplierBoard = array<array<uint8_t, BOARD_SIZE>, BOARD_SIZE>;
+
+    // Square -> letter multiplier (1, 2 or 3)
+    constexpr MultiplierBoard buildLetterMultipliers() {
+        MultiplierBoard mult{};
+        for (int r = 0; r < BOARD_SIZE; r++) {
+            for (int c = 0; c < BOARD_SIZE; c++) {
+                CellType cell = BONUS_BOARD[r][c];
+                mult[r][c] = (cell == CellType::DLS) ? 2 : (cell == CellType::TLS) ? 3 : 1;
+            }
+        }
+        return mult;
+    }
+
+    // Square -> word multiplier (1, 2 or 3)
+    constexpr MultiplierBoard buildWordMultipliers() {
+        MultiplierBoard mult{};
+        for (int r = 0; r < BOARD_SIZE; r++) {
+            for (int c = 0; c < BOARD_SIZE; c++) {
+                CellType cell = BONUS_BOARD[r][c];
+                mult[r][c] = (cell == CellType::DWS) ? 2 : (cell == CellType::TWS) ? 3 : 1;
+            }
+        }
+        return mult;
+    }
+
+    inline constexpr MultiplierBoard LETTER_MULT = buildLetterMultipliers();
+    inline constexpr MultiplierBoard WORD_MULT = buildWordMultipliers();
+
+    // A tile placed this turn. 'letter' is always uppercase.
+    struct PlacedTile {
+        int8_t row;
+        int8_t col;
+        char letter;
+        bool isBlank;
+    };
+
+    // All tiles placed by one move, in board order along the main line.
+    struct Placement {
+        PlacedTile tiles[BOARD_SIZE];
+        int count = 0;
+        bool horizontal = true;
+
+        void add(int row, int col, char letter, bool isBlank) {
+            tiles[count++] = {static_cast<int8_t>(row), static_cast<int8_t>(col), letter, isBlank};
+        }
+    };
+
+    // Builds a placement from a full-line word (existing board letters included,
+    // lowercase = blank), which is the format the move generator produces.
+    // Returns false if the word runs off the board.
+    bool placementFromWord(const LetterBoard &letters, int row, int col, bool horizontal,
+                           const char *word, Placement &out);
+
+    // THE KERNEL: scores a placement against the pre-move board.
+    // Main word + all cross words + bingo bonus. 'blanks' may be nullptr when
+    // the board itself marks blanks in lowercase (search boards).
+    int scorePlacement(const LetterBoard &letters, const BlankBoard *blanks, const Placement &placement);
+}
@@ -1,7 +1,42 @@
 #pragma once
 
+#include <cstdint>
 #include "types.h"
 
+// Read-only view of the tiles one player cannot see (bag + opponent's rack),
+// as a 27-slot histogram (slot 0-25 = 'A'-'Z', 26 = blank).
+struct UnseenView {
+    const uint8_t* counts = nullptr;
+    int total = 0;
+
+    int countOf(char letter) const {
+        int slot = TileRack::slotOf(letter);
+        return (slot >= 0) ? counts[slot] : 0;
+    }
+
+    template <typename Count>
+    void fillCounts(Count* out) const {
+        for (int i = 0; i < TileBag::SLOTS; i++) out[i] = counts[i];
+    }
+};
+
+// Unseen-tile histograms for both players.
+// Maintained incrementally by Mechanics (plays, draws, exchanges, undo);
+// use Mechanics::rebuildUnseen after editing a state directly.
+struct UnseenTiles {
+    uint8_t counts[2][TileBag::SLOTS] = {};
+    int total[2] = {0, 0};
+
+    void add(int player, int slot, int n) {
+        counts[player][slot] = static_cast<uint8_t>(counts[player][slot] + n);
+        total[player] += n;
+    }
+
+    UnseenView view(int player) const {
+        return UnseenView{counts[player], total[player]};
+    }
+};
+
 struct GameState {
     LetterBoard board;
     BlankBoard blanks;
@@ -11,12 +46,42 @@ struct GameState {
     int currentPlayerIndex = 0;
     bool dictActive = true;
 
+    // Zobrist key of the position (see engine/zobrist.h).
+    // Kept up to date by the Mechanics functions; recompute after editing the state directly.
+    uint64_t hash = 0;
+
+    // What each player has not seen yet (see UnseenTiles)
+    UnseenTiles unseen;
+
+    UnseenView unseenFor(int playerIdx) const {
+        return unseen.view(playerIdx);
+    }
+
     // Helper to create a deep copy ( For AI simulation )
     GameState clone() const {
         return *this;
     }
 };
 
+// Everything Mechanics::applyMove changed, so the move can be taken back
+// without snapshotting the whole GameState (placed squares + rack deltas).
+struct MoveUndo {
+    int playerIndex = -1;
+    int score = 0;
+    int prevPassCount = 0;
+
+    // Squares filled by the move (row * BOARD_SIZE + col), in placement order
+    int placedCount = 0;
+    uint8_t placedSquares[BOARD_SIZE];
+
+    // Tiles taken from the rack and the rack slot each one came from
+    Tile removedTiles[BOARD_SIZE];
+    uint8_t removedSlots[BOARD_SIZE];
+
+    // Tiles drawn from the bag (appended to the end of the rack)
+    int drawnCount = 0;
+};
+
 struct LastMoveInfo {
     bool exists = false;
     int playerIndex = -1;
@@ -9,7 +9,7 @@ using namespace std;
 TileBag createStandardTileBag();
 
 // Print the tile bag
-void printTileBag(const TileBag &bag, const vector<Tile> &opponentRack, bool revealOpponentRack);
+void printTileBag(const TileBag &bag, const TileRack &opponentRack, bool revealOpponentRack);
 
 // Shuffle the tile bag
 void shuffleTileBag(TileBag &bag);
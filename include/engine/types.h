@@ -3,6 +3,8 @@
 #include <vector>
 #include <array>
 #include <string>
+#include <cstddef>
+#include <cstdint>
 
 using namespace std;
 
@@ -33,11 +35,145 @@ struct Tile{
     int points; //score value
 };
 
-// A rack is the 7 tiles a player holds
-using TileRack = vector<Tile>;
+// A rack is the 7 tiles a player holds.
+// Fixed-capacity inline storage, so copying or editing a rack never touches
+// the heap. It keeps the small vector-style API the engine already uses
+// (push_back, erase, insert, iterators) plus histogram helpers.
+class TileRack {
+public:
+    static constexpr int CAPACITY = 7;
+
+    using iterator = Tile*;
+    using const_iterator = const Tile*;
+
+    TileRack() = default;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == CAPACITY; }
+    void clear() { count = 0; }
+
+    Tile& operator[](size_t i) { return tiles[i]; }
+    const Tile& operator[](size_t i) const { return tiles[i]; }
+    Tile& back() { return tiles[count - 1]; }
+    const Tile& back() const { return tiles[count - 1]; }
+
+    iterator begin() { return tiles; }
+    iterator end() { return tiles + count; }
+    const_iterator begin() const { return tiles; }
+    const_iterator end() const { return tiles + count; }
+
+    // Extra tiles past CAPACITY are ignored (a rack can never hold more than 7)
+    void push_back(const Tile& t) {
+        if (count < CAPACITY) tiles[count++] = t;
+    }
+
+    void pop_back() {
+        if (count > 0) count--;
+    }
+
+    iterator erase(iterator pos) {
+        for (iterator it = pos; it + 1 < end(); ++it) *it = *(it + 1);
+        count--;
+        return pos;
+    }
+
+    iterator insert(iterator pos, const Tile& t) {
+        if (count >= CAPACITY) return pos;
+        for (iterator it = end(); it > pos; --it) *it = *(it - 1);
+        *pos = t;
+        count++;
+        return pos;
+    }
+
+    // Histogram slot of a letter: 'A'-'Z' (either case) -> 0-25, '?' -> 26, else -1
+    static constexpr int slotOf(char letter) {
+        if (letter >= 'A' && letter <= 'Z') return letter - 'A';
+        if (letter >= 'a' && letter <= 'z') return letter - 'a';
+        if (letter == '?') return 26;
+        return -1;
+    }
+
+    // Writes the 27-slot histogram of the rack into 'counts'
+    template <typename Count>
+    void fillCounts(Count* counts) const {
+        for (int i = 0; i < 27; i++) counts[i] = 0;
+        for (int i = 0; i < count; i++) {
+            int slot = slotOf(tiles[i].letter);
+            if (slot >= 0) counts[slot]++;
+        }
+    }
+
+    // How many tiles of 'letter' the rack holds ('?' counts blanks)
+    int countOf(char letter) const {
+        int slot = slotOf(letter);
+        int n = 0;
+        for (int i = 0; i < count; i++) {
+            if (slotOf(tiles[i].letter) == slot) n++;
+        }
+        return n;
+    }
+
+    // Slot index of the first tile matching 'letter', or -1
+    int find(char letter) const {
+        int slot = slotOf(letter);
+        for (int i = 0; i < count; i++) {
+            if (slotOf(tiles[i].letter) == slot) return i;
+        }
+        return -1;
+    }
 
-// Tile bag
-using TileBag = vector<Tile>;
+private:
+    Tile tiles[CAPACITY];
+    int count = 0;
+};
+
+// Tile bag.
+// Stored as letter counts (27 slots) with its own RNG, so every game (and
+// every simulation copy) draws independently and a copy is a few dozen bytes.
+// draw() is uniform over the remaining tiles, exactly like drawing from a
+// shuffled bag.
+class TileBag {
+public:
+    static constexpr int SLOTS = 27;
+
+    TileBag() = default;
+
+    size_t size() const { return total; }
+    bool empty() const { return total == 0; }
+    void clear();
+
+    // Put tiles (back) into the bag
+    void push_back(const Tile& t);
+    void add(char letter, int n);
+
+    // Remove one random tile (the bag must not be empty)
+    Tile draw();
+
+    // Remove a specific tile, returns false if the bag has none left
+    bool remove(char letter);
+
+    // Per-bag random stream (see shuffleTileBag for entropy seeding)
+    void seed(uint64_t s) { rngState = s; }
+
+    int countOf(char letter) const {
+        int slot = TileRack::slotOf(letter);
+        return (slot >= 0) ? counts[slot] : 0;
+    }
+
+    // Writes the 27-slot histogram of the bag into 'out'
+    template <typename Count>
+    void fillCounts(Count* out) const {
+        for (int i = 0; i < SLOTS; i++) out[i] = counts[i];
+    }
+
+private:
+    uint8_t counts[SLOTS] = {0};
+    int total = 0;
+    uint64_t rngState = 0x853C49E6748FEA9BULL;
+
+    uint64_t nextRandom();
+};
 
 // 2D board type
 using Board = array < array < CellType, BOARD_SIZE >, BOARD_SIZE>;
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include "types.h"
+#include "state.h"
+
+// ================================================================
+//                      ZOBRIST HASHING
+// ================================================================
+// 64-bit position keys: letter per square (blank-aware), each player's
+// rack histogram, side to move and the unseen pool (the bag).
+// Racks and the pool are multisets, so they are keyed by (letter, count)
+// rather than per tile: changing a count XORs out the old key and XORs in
+// the new one. Count 0 has key 0, so empty histograms cost nothing.
+namespace Zobrist {
+
+    constexpr int SLOT_COUNT = 27;      // 'A'-'Z' + blank
+    constexpr int MAX_TILE_COUNT = 13;  // highest count of one letter (E x12) + 1
+    constexpr int SQUARE_LETTERS = 52;  // 26 letters + 26 blank letters
+
+    struct Keys {
+        uint64_t square[BOARD_SIZE * BOARD_SIZE][SQUARE_LETTERS];
+        uint64_t rack[2][SLOT_COUNT][MAX_TILE_COUNT];
+        uint64_t pool[SLOT_COUNT][MAX_TILE_COUNT];
+        uint64_t sideToMove;
+    };
+
+    // splitmix64: tiny, good-quality generator that works at compile time
+    constexpr uint64_t nextKey(uint64_t &state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr Keys buildKeys() {
+        Keys keys{};
+        uint64_t state = 0x5C0FFEE5C0FFEEULL;
+
+        for (auto &sq : keys.square) {
+            for (auto &k : sq) k = nextKey(state);
+        }
+        for (auto &player : keys.rack) {
+            for (auto &slot : player) {
+                slot[0] = 0;
+                for (int n = 1; n < MAX_TILE_COUNT; n++) slot[n] = nextKey(state);
+            }
+        }
+        for (auto &slot : keys.pool) {
+            slot[0] = 0;
+            for (int n = 1; n < MAX_TILE_COUNT; n++) slot[n] = nextKey(state);
+        }
+        keys.sideToMove = nextKey(state);
+        return keys;
+    }
+
+    inline constexpr Keys KEYS = buildKeys();
+
+    // 'A'-'Z' / 'a'-'z' -> 0-25, '?' -> 26, anything else -> -1
+    constexpr int slotOf(char letter) {
+        return TileRack::slotOf(letter);
+    }
+
+    // Key of 'letter' sitting on (row, col). Lowercase letters count as blanks.
+    inline uint64_t squareKey(int row, int col, char letter, bool isBlank) {
+        int idx = slotOf(letter);
+        if (idx < 0 || idx > 25) return 0;
+        if (isBlank || (letter >= 'a' && letter <= 'z')) idx += 26;
+        return KEYS.square[row * BOARD_SIZE + col][idx];
+    }
+
+    // Key of a whole histogram (27 counts)
+    template <typename Count>
+    inline uint64_t rackKey(int player, const Count *counts) {
+        uint64_t h = 0;
+        for (int i = 0; i < SLOT_COUNT; i++) h ^= KEYS.rack[player][i][counts[i]];
+        return h;
+    }
+
+    template <typename Count>
+    inline uint64_t poolKey(const Count *counts) {
+        uint64_t h = 0;
+        for (int i = 0; i < SLOT_COUNT; i++) h ^= KEYS.pool[i][counts[i]];
+        return h;
+    }
+
+    // Histogram-key helpers for the engine containers
+    uint64_t rackKey(int player, const TileRack &rack);
+    uint64_t poolKey(const TileBag &bag);
+
+    // Full key from scratch (game start, validation)
+    uint64_t compute(const GameState &state);
+}
@@ -2,20 +2,16 @@
 #include <cctype>
 #include <algorithm>
 #include "tile_tracker.h"
+#include "engine/scoring.h"
 
 namespace spectre {
 
     class Heuristics {
     public:
         // [USED BY SPEED_PI & GAME ENGINE]
+        // Same compile-time table as the scoring kernel (lowercase/'?' = blank = 0)
         static int getTileValue(char letter) {
-            static const int values[] = {
-                1, 3, 3, 2, 1, 4, 2, 4, 1, 8, 5, 1, 3, 1, 1, 3, 10, 1, 1, 1, 1, 4, 4, 8, 4, 10, 0
-            };
-            if (letter == '?') return 0;
-            int idx = toupper(letter) - 'A';
-            if (idx >= 0 && idx < 26) return values[idx];
-            return 0;
+            return Scoring::letterValue(letter);
         }
 
         // [USED BY VANGUARD] - Quackle/Maven Static Leave Values
@@ -56,12 +52,88 @@ namespace spectre {
             return 0.0f;
         }
 
-        // [LEGACY SUPPORT] - Stub for AIPlayer to prevent build errors
-        static void updateWeights(const TileTracker& tracker) {
-            // In a full implementation, this would adjust dynamic weights
-            // based on the remaining tiles in 'tracker'.
-            // For now, we keep it empty to allow compilation.
-            (void)tracker;
+        // --- Per-turn leave weights ---
+        // Built once per decision from the unseen pool, read by Treasurer::turnLeaveValue.
+        // adjust[slot][k] is added for keeping k copies of a letter; 'scale' shrinks
+        // the leave as the bag runs out (fewer draws left to profit from it).
+        struct LeaveWeights {
+            static constexpr int SLOTS = 27;
+            static constexpr int MAX_COPIES = 8;
+
+            float scale = 1.0f;
+            float adjust[SLOTS][MAX_COPIES] = {};
+        };
+
+        static constexpr float VOWEL_POOL_WEIGHT = 10.0f;  // per tile, per unit of vowel-ratio drift
+        static constexpr float DUPLICATE_WEIGHT = 12.0f;   // per copy, per unit of draw-odds drift
+        static constexpr float NO_U_PENALTY = 5.0f;        // Q kept with every U already seen
+        static constexpr int LEAVE_FULL_BAG = 14;          // Bag size from which leaves count fully
+
+        // Weights of the calling thread (neutral until updateWeights runs on it)
+        static LeaveWeights& turnWeights() {
+            thread_local LeaveWeights weights;
+            return weights;
+        }
+
+        // 'unseen' = 27 counts (bag + opponent rack), 'bagSize' = tiles left to draw
+        template <typename Count>
+        static void updateWeights(const Count* unseen, int bagSize) {
+            static const int FULL_DIST[LeaveWeights::SLOTS] =
+                {9,2,2,4,12,2,3,2,9,1,1,4,2,6,8,2,1,6,4,6,4,2,2,1,2,1,2};
+            static const double FULL_VOWEL_RATIO = 42.0 / 98.0;
+
+            LeaveWeights& w = turnWeights();
+            w = LeaveWeights();
+            w.scale = std::min(1.0f, std::max(0, bagSize) / static_cast<float>(LEAVE_FULL_BAG));
+
+            int total = 0, letters = 0, vowels = 0;
+            for (int i = 0; i < LeaveWeights::SLOTS; i++) {
+                total += unseen[i];
+                if (i == 26) continue;
+                letters += unseen[i];
+                if (isVowelSlot(i)) vowels += unseen[i];
+            }
+            if (total == 0) return;
+
+            // Vowel-heavy pool: kept vowels get worse, kept consonants better (and vice versa)
+            double vowelDrift = (letters > 0) ? (static_cast<double>(vowels) / letters - FULL_VOWEL_RATIO) : 0.0;
+
+            for (int i = 0; i < LeaveWeights::SLOTS; i++) {
+                float perTile = 0.0f;
+                if (i != 26) {
+                    perTile = static_cast<float>((isVowelSlot(i) ? -vowelDrift : vowelDrift) * VOWEL_POOL_WEIGHT);
+                }
+
+                // More copies unseen than usual = higher odds of drawing a duplicate.
+                // S and blanks are welcome twice, so they are left alone.
+                float perCopy = 0.0f;
+                if (i != 26 && i != ('S' - 'A')) {
+                    double drift = static_cast<double>(unseen[i]) / total - FULL_DIST[i] / 100.0;
+                    perCopy = static_cast<float>(-drift * DUPLICATE_WEIGHT * 7.0);
+                }
+
+                for (int k = 1; k < LeaveWeights::MAX_COPIES; k++) {
+                    w.adjust[i][k] = w.scale * k * (perTile + perCopy);
+                }
+            }
+
+            // A Q with no U left to draw
+            if (unseen['U' - 'A'] == 0) {
+                for (int k = 1; k < LeaveWeights::MAX_COPIES; k++) w.adjust['Q' - 'A'][k] -= w.scale * NO_U_PENALTY * k;
+            }
+        }
+
+        static void updateWeights(const TileTracker& tracker, int bagSize) {
+            int unseen[LeaveWeights::SLOTS];
+            for (int i = 0; i < LeaveWeights::SLOTS; i++) {
+                unseen[i] = tracker.getUnseenCount(i == 26 ? '?' : static_cast<char>('A' + i));
+            }
+            updateWeights(unseen, bagSize);
+        }
+
+    private:
+        static bool isVowelSlot(int slot) {
+            return slot == 0 || slot == 4 || slot == 8 || slot == 14 || slot == 20; // A E I O U
         }
     };
 
@@ -19,8 +19,7 @@ private:
     // Your specific helpers
     Move handleRackLogic(TileRack &rack, TileBag &bag);
 
-    Move parseMoveInput(const Board &bonusBoard,
-                        const GameState &state, // Passed state for Preview/Validation
+    Move parseMoveInput(const GameState &state, // Passed state for Preview/Validation
                         const LetterBoard &letters,
                         const BlankBoard &blankBoard,
                         const TileRack &rack,
@@ -26,5 +26,5 @@ public:
     virtual std::string getName() const { return "Player"; }
 
     // Hook for the Spy to see the move BEFORE it was applied (Snapshot)
-    virtual void observeMove(const Move& move, const LetterBoard& preMoveBoard) {}
+    virtual void observeMove(const Move& move, const LetterBoard& preMoveBoard, const BlankBoard& preMoveBlanks) {}
 };
\ No newline at end of file
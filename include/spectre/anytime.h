@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+#include "move_generator.h"
+
+namespace spectre {
+
+    // Snapshot of a running search
+    struct SearchProgress {
+        MoveCandidate best{};       // Best move so far (word[0] == '\0' = none yet)
+        bool hasMove = false;
+        double value = 0.0;         // Engine specific: mean equity (Vanguard), spread (Judge)
+        int iterations = 0;         // Playouts (Vanguard) or root moves searched at 'depth' (Judge)
+        int depth = 0;              // Completed search depth, if the engine has one
+        long long elapsedMs = 0;
+        bool finished = false;      // Search returned (completed, cancelled or out of time)
+    };
+
+    using ProgressCallback = std::function<void(const SearchProgress&)>;
+
+    // What a search checks while it runs: an absolute deadline, a stop token and
+    // where to report its best-so-far move. Shared by Vanguard and Judge.
+    class SearchControl {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        SearchControl(Clock::time_point deadline,
+                      std::stop_token stop = {},
+                      ProgressCallback onProgress = {});
+
+        // Deadline 'timeLimitMs' from now
+        static SearchControl withBudget(int timeLimitMs,
+                                        std::stop_token stop = {},
+                                        ProgressCallback onProgress = {});
+
+        // True once cancelled or past the deadline (cheap, call it in the hot loop)
+        bool shouldStop() const {
+            return stop.stop_requested() || Clock::now() >= deadline;
+        }
+
+        Clock::time_point getDeadline() const { return deadline; }
+        long long elapsedMs() const;
+
+        // Publishes the current best (stamps the elapsed time) and calls the callback
+        void report(SearchProgress progress);
+        SearchProgress latest() const;
+
+    private:
+        Clock::time_point start;
+        Clock::time_point deadline;
+        std::stop_token stop;
+        ProgressCallback onProgress;
+
+        mutable std::mutex mutex;
+        SearchProgress current;
+    };
+
+    // Runs one search on its own thread. The caller can poll the best-so-far,
+    // get callbacks, cancel it, or wait for the final move; nothing blocks
+    // until result() is called.
+    class AnytimeSearch {
+    public:
+        using SearchFn = std::function<MoveCandidate(SearchControl&)>;
+
+        AnytimeSearch() = default;
+        ~AnytimeSearch();
+
+        AnytimeSearch(const AnytimeSearch&) = delete;
+        AnytimeSearch& operator=(const AnytimeSearch&) = delete;
+
+        // Starts 'search' with a deadline 'timeLimitMs' from now (cancels any previous one)
+        void start(SearchFn search, int timeLimitMs, ProgressCallback onProgress = {});
+
+        SearchProgress poll() const;
+        bool finished() const;
+
+        // Asks the search to stop; it still reports its best move
+        void cancel();
+
+        // Waits for the search and returns its move
+        MoveCandidate result();
+
+    private:
+        std::stop_source stopSource;
+        std::unique_ptr<SearchControl> control;
+        std::jthread worker; // Declared last: joined before 'control' goes away
+        MoveCandidate finalMove{};
+    };
+
+}
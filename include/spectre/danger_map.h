@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "move_generator.h"
+#include "../../include/engine/types.h"
+
+namespace spectre {
+
+    // ================================================================
+    //                      PER-TURN DANGER MAP
+    // ================================================================
+    // Built once per board. A "premium line" is one empty triple-word square
+    // played through in one direction (8 squares x 2 = 16 lines, one bit each).
+    // For every empty square the map holds the lines a tile there would open,
+    // so the danger of a move is an OR over the squares it fills.
+    //
+    // A tile opens a line when it sits on the line within LINE_REACH squares
+    // of the TWS with nothing between, or right beside the TWS (a hook or a
+    // parallel play through it). Lines the board already opens are masked out.
+    class DangerMap {
+    public:
+        static constexpr int MAX_LINES = 16;
+        static constexpr int LINE_REACH = 4;    // 5-letter words through the TWS
+        static constexpr int LINE_WORD = 5;     // Word length the threat is priced at
+        static constexpr int AVG_TILE_POINTS = 2;
+
+        void build(const LetterBoard& board);
+
+        // Lines a tile on (r, c) would newly open (0 for occupied squares)
+        uint32_t squareMask(int r, int c) const { return masks[r][c]; }
+
+        // OR over the empty squares a word covers ('board' = before the move)
+        uint32_t maskOf(const MoveCandidate& move, const LetterBoard& board) const;
+        // Engine form: 'word' is the placed letters only (Move::word)
+        uint32_t maskOf(const std::string& word, int row, int col, bool horizontal,
+                        const LetterBoard& board) const;
+
+        // Points the opponent could expect through the best opened line
+        int threatOf(uint32_t mask) const;
+
+        // Lines the current board already leaves open
+        uint32_t openLines() const { return alreadyOpen; }
+
+    private:
+        uint32_t masks[BOARD_SIZE][BOARD_SIZE];
+        int lineThreat[MAX_LINES];
+        uint32_t alreadyOpen = 0;
+    };
+
+}
@@ -3,47 +3,92 @@
 #include <vector>
 #include <array>
 #include <chrono>
+#include <cstdint>
 
 #include "move_generator.h"
 #include "../engine/board.h"
 #include "../../include/engine/rack.h"
 #include "../../include/move.h"
 #include "../engine/dictionary.h"
+#include "anytime.h"
 
 namespace spectre {
 
+// Undo record for one ply of the search: the squares a move filled and the
+// rack histogram slot that paid for each tile. Enough to take the move back
+// without copying the board.
+struct PlyUndo {
+    int count = 0;
+    uint8_t squares[BOARD_SIZE];   // row * BOARD_SIZE + col
+    uint8_t rackSlots[BOARD_SIZE]; // 0-25 letter, 26 blank, 0xFF none
+};
+
 class Judge {
 public:
+    // Budget of the blocking solveEndgame form
+    static constexpr int DEFAULT_TIME_BUDGET_MS = 4000;
+    // Iterative deepening stops here (both racks empty well before this)
+    static constexpr int MAX_PLIES = 16;
+
     /**
      * @brief THE EXECUTIONER.
      * Solves the Scrabble Endgame using Minimax with Alpha-Beta Pruning.
      * * @param board The current state of the letter board.
-     * @param bonusBoard The static bonus board (DL, TL, DW, TW).
      * @param myRack The AI's current rack.
      * @param oppRack The Opponent's inferred rack (Perfect Info).
      * @param dict The GADDAG dictionary.
+     * @param scoreDiff (MyScore - OppScore) now. Once a root move is found that
+     *        wins the game (WinModel::DECIDED), the rest are not searched.
+     * @param timeBudgetMs Time allowed for the search.
      * @return Move The move that maximizes (MyScore - OppScore) to the end of the game.
      */
     static Move solveEndgame(const LetterBoard& board,
-                             const Board& bonusBoard,
                              const TileRack& myRack,
                              const TileRack& oppRack,
-                             Dictionary& dict);
+                             Dictionary& dict,
+                             int scoreDiff,
+                             int timeBudgetMs = DEFAULT_TIME_BUDGET_MS);
+
+    /**
+     * @brief Anytime form of solveEndgame.
+     * Iterative deepening over a shared transposition table. Reports the best
+     * move after each completed depth; when 'control' stops the search the last
+     * completed depth's answer is returned (see AnytimeSearch).
+     *
+     * Root moves are split over the thread pool: the first one is searched
+     * alone, then the rest in parallel against the best value so far.
+     *
+     * @param fixedPlies > 0 searches exactly that depth on a cleared table, with
+     *        table hits limited to the same depth and ties going to the earlier
+     *        root move: the answer does not depend on thread count or timing.
+     */
+    static MoveCandidate searchEndgame(const LetterBoard& board,
+                                       const TileRack& myRack,
+                                       const TileRack& oppRack,
+                                       Dictionary& dict,
+                                       int scoreDiff,
+                                       SearchControl& control,
+                                       int fixedPlies = 0);
 
 private:
     /**
-     * @brief Recursive Minimax Driver.
+     * @brief Recursive Minimax Driver (negamax, alpha-beta, transposition table).
      * * @param board Copy of board state for simulation.
-     * @param myRackCounts Histogram of AI's tiles.
-     * @param oppRackCounts Histogram of Opponent's tiles.
+     * @param myRackCounts Histogram of the side to move's tiles.
+     * @param oppRackCounts Histogram of the other side's tiles.
      * @param alpha Best score for Maximizer (Lower Bound).
      * @param beta Best score for Minimizer (Upper Bound).
      * @param maximizingPlayer True if it's AI's turn, False if Opponent's.
      * @param passesInARow Detection for game-over via passing.
+     * @param depth Plies from the root (beam width, clock checks).
+     * @param remaining Plies left before the horizon (best single move there).
+     * @param boardKey Zobrist key of the board's letters.
+     * @param horizon Set when the value depends on a horizon node.
+     * @param strictDepth Only use table entries of exactly 'remaining' plies
+     *        (fixed-depth mode, keeps the value independent of table contents).
      * @return int The final Score Differential.
      */
-    static int minimax(LetterBoard board,
-                   const Board& bonusBoard,
+    static int minimax(LetterBoard& board,
                    int* myRackCounts,
                    int* oppRackCounts,
                    Dictionary& dict,
@@ -52,18 +97,26 @@ private:
                    bool maximizingPlayer,
                    int passesInARow,
                    int depth,
-                   const std::chrono::steady_clock::time_point& startTime,
-                   int timeBudgetMs);
+                   int remaining,
+                   uint64_t boardKey,
+                   bool& horizon,
+                   bool strictDepth,
+                   const SearchControl& control);
 
     // Precise Scoring Engine (Internal)
     static int calculateMoveScore(const LetterBoard& board,
-                                  const Board& bonusBoard,
                                   const MoveCandidate& move);
 
-    // State Managment
+    // State Managment (Make / Unmake)
+    // Blanks are written to the board in lowercase so the scoring kernel values them at 0.
     static void applyMove(LetterBoard& board,
                           const MoveCandidate& move,
-                          int* rackCounts);
+                          int* rackCounts,
+                          PlyUndo& undo);
+
+    static void undoMove(LetterBoard& board,
+                         const PlyUndo& undo,
+                         int* rackCounts);
 };
 
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <string>
+#include <cstring>
+#include <cctype>
 #include "../engine/board.h"
 #include "../../include/engine/rack.h"
 #include "../../include/fast_constraints.h"
@@ -22,6 +24,27 @@ struct MoveCandidate {
     char leave[8]; // Remaining tiles
 };
 
+// Transposed board and row constraints of one position. Building them is the
+// rack-independent part of move generation, so callers that query several
+// racks on the same board build them once (see MoveGenerator::generate_prepared).
+struct BoardConstraints {
+    LetterBoard transposed;
+    RowConstraint horizontal[15];
+    RowConstraint vertical[15];
+
+    void build(const LetterBoard &board) {
+        for (int r = 0; r < 15; r++) {
+            for (int c = 0; c < 15; c++) {
+                transposed[c][r] = board[r][c];
+            }
+        }
+        for (int i = 0; i < 15; i++) {
+            horizontal[i] = ConstraintGenerator::generateRowConstraint(board, i);
+            vertical[i] = ConstraintGenerator::generateRowConstraint(transposed, i);
+        }
+    }
+};
+
 class MoveGenerator {
 public:
     // -------------------------------------------------------------------------
@@ -31,36 +54,28 @@ public:
     // -------------------------------------------------------------------------
     template <typename Consumer>
     static void generate_raw(const LetterBoard &board, int* rackCounts, Dictionary &dict, Consumer& consumer) {
+        // Constraints on the stack, built for this one query
+        BoardConstraints constraints;
+        constraints.build(board);
+        generate_prepared(board, constraints, rackCounts, dict, consumer);
+    }
 
-        // 1. Transpose Board (Stack Allocation)
-        LetterBoard transposed;
-        for (int r = 0; r < 15; r++) {
-            for (int c = 0; c < 15; c++) {
-                transposed[c][r] = board[r][c];
-            }
-        }
-
-        // 2. Pre-calculate Constraints (Stack Allocation)
-        RowConstraint constraintsH[15];
-        RowConstraint constraintsV[15];
-        for(int i=0; i<15; i++) {
-            constraintsH[i] = ConstraintGenerator::generateRowConstraint(board, i);
-            constraintsV[i] = ConstraintGenerator::generateRowConstraint(transposed, i);
-        }
-
-        // 3. Execute Search
+    // Same, on constraints built beforehand for 'board'
+    template <typename Consumer>
+    static void generate_prepared(const LetterBoard &board, const BoardConstraints &constraints,
+                                  int* rackCounts, Dictionary &dict, Consumer& consumer) {
         int localRack[27];
 
         // Horizontal
         for (int r = 0; r < 15; r++) {
             memcpy(localRack, rackCounts, 27 * sizeof(int));
-            if (!genMovesGADDAG(r, board, localRack, constraintsH[r], true, dict, consumer)) return;
+            if (!genMovesGADDAG(r, board, localRack, constraints.horizontal[r], true, dict, consumer)) return;
         }
 
         // Vertical
         for (int r = 0; r < 15; r++) {
             memcpy(localRack, rackCounts, 27 * sizeof(int));
-            if (!genMovesGADDAG(r, transposed, localRack, constraintsV[r], false, dict, consumer)) return;
+            if (!genMovesGADDAG(r, constraints.transposed, localRack, constraints.vertical[r], false, dict, consumer)) return;
         }
     }
 
@@ -111,7 +126,7 @@ private:
         // Calculate what is already on the board in this row
         uint32_t boardRowMask = 0;
         for(int c = 0; c < 15; c++) {
-            if(board[row][c] != ' ') boardRowMask |= (1 << (board[row][c] - 'A'));
+            if(board[row][c] != ' ') boardRowMask |= (1 << (toupper(board[row][c]) - 'A'));
         }
 
         // Initial Pruning Mask: Rack + Board + Separator
@@ -174,8 +189,8 @@ private:
         uint32_t effectiveMask = dict.nodes[node].edgeMask;
 
         if (boardChar != ' ') {
-            // Existing Tile: Must match
-            int charIdx = boardChar - 'A';
+            // Existing Tile: Must match (search boards keep blanks in lowercase)
+            int charIdx = toupper(boardChar) - 'A';
             if (!((effectiveMask >> charIdx) & 1)) return true;
 
             wordBuf[wordLen] = boardChar;
@@ -256,7 +271,7 @@ private:
 
         if (boardChar != ' ') {
             // Existing Tile
-            int charIdx = boardChar - 'A';
+            int charIdx = toupper(boardChar) - 'A';
             if (!((effectiveMask >> charIdx) & 1)) return true;
 
             wordBuf[wordLen] = boardChar;
@@ -15,7 +15,7 @@ namespace spectre {
 
     struct ProfileData {
         int turnsAnalyzed = 0;
-        int riskyMoves = 0;   // Times they left a TWS open
+        int riskyMoves = 0;   // Times they opened a TWS lane
         OpponentType type = OpponentType::UNKNOWN;
     };
 
@@ -4,37 +4,99 @@
 #include "../../include/move.h"
 #include "../../include/engine/rack.h"
 #include "../engine/tiles.h"
+#include "../engine/state.h"
 #include "profiler.h"
+#include <cstdint>
 #include <vector>
 #include <random>
 
 namespace spectre {
 
-    struct Particle {
-        std::vector<char> rack;
-        double weight;
-    };
-
     class Spy {
     public:
         Spy();
 
         void observeOpponentMove(const Move& move, const LetterBoard& preMoveBoard, OpponentType oppType);
-        void updateGroundTruth(const LetterBoard& board, const TileRack& myRack, const TileBag& bag);
+        // Syncs with the game's unseen-tile histogram (bag + opponent rack)
+        void updateGroundTruth(const UnseenView& unseen);
         std::vector<char> generateWeightedRack() const;
+        // Same draw into a 27-slot histogram (no allocation); returns the rack size
+        int sampleRack(int* counts) const;
+
+        // Exact mode: with few tiles unseen, every possible opponent rack with its
+        // hypergeometric weight (weights sum to 1). Draws above come from this list
+        // then, and an empty bag leaves exactly one rack.
+        struct RackWeight {
+            uint8_t counts[27];
+            uint8_t size;
+            double weight;
+        };
+        bool hasExactRacks() const { return !exactRacks.empty(); }
+        const std::vector<RackWeight>& getExactRacks() const { return exactRacks; }
+
+        // The exact mode's likeliest rack, or a particle draw
+        std::vector<char> likeliestRack() const;
+
+        // Unseen pool as last synced (27-slot histogram)
+        const int* getUnseenCounts() const { return unseenCounts; }
+        int getUnseenTotal() const { return unseenTotal; }
 
     private:
-        std::vector<char> unseenPool;
-        std::vector<Particle> particles;
-        const int PARTICLE_COUNT = 1000;
+        static constexpr int SLOTS = 27;
+        static constexpr int PARTICLE_COUNT = 4096;
+
+        // Exact mode: pools up to EXACT_POOL_MAX tiles, at most EXACT_RACK_LIMIT racks
+        static constexpr int EXACT_POOL_MAX = 16;
+        static constexpr int EXACT_RACK_LIMIT = 4096;
+
+        // Negative inference (SMART opponents): a rack's likelihood falls by e
+        // for every INFERENCE_TEMPERATURE points of equity the actual play left
+        // on the table, down to INFERENCE_FLOOR. The most common distinct racks
+        // are scored first, up to INFERENCE_RACKS or the time budget.
+        static constexpr double INFERENCE_TEMPERATURE = 15.0;
+        static constexpr double INFERENCE_FLOOR = 0.05;
+        static constexpr int INFERENCE_RACKS = 512;
+        static constexpr int INFERENCE_BUDGET_MS = 150;
+
+        int unseenCounts[27] = {0};
+        int unseenTotal = 0;
+
+        // Particles as a structure of arrays: particle i's rack histogram is
+        // rackCounts[i * SLOTS .. i * SLOTS + SLOTS)
+        std::vector<uint8_t> rackCounts;
+        std::vector<uint8_t> rackSizes;
+        std::vector<double> weights;
+
+        // Exact mode racks and their running weight sums (for drawing)
+        std::vector<RackWeight> exactRacks;
+        std::vector<double> exactCumulative;
+
+        // Unseen pool as one entry per tile (rebuilt by each refill)
+        static constexpr int MAX_UNSEEN = 100;
+        uint8_t tileSlot[MAX_UNSEEN] = {0};
+        uint8_t tileCopy[MAX_UNSEEN] = {0};
+        // Pool the particles were last refilled from (racks never exceed it)
+        int refilledFrom[27] = {0};
+
+        // Resampling target, swapped with the live buffers (no per-turn allocation)
+        std::vector<uint8_t> spareCounts;
+        std::vector<uint8_t> spareSizes;
+
+        uint8_t* rackOf(int i) { return &rackCounts[static_cast<size_t>(i) * SLOTS]; }
+        const uint8_t* rackOf(int i) const { return &rackCounts[static_cast<size_t>(i) * SLOTS]; }
 
         // Internal Logic
-        int findBestPossibleScore(const std::vector<char>& rack, const LetterBoard& board);
+        // Likelihood of each particle's rack given the play (particles with weight 0 skipped)
+        void weighByPlay(const Move& move, const LetterBoard& board, const int* played);
 
         void initParticles();
+        // Tops every rack up to 7 (or the whole pool) from what it does not hold
+        void refillParticles();
+        // Fills exactRacks, or leaves it empty when the pool has too many racks
+        void enumerateRacks();
 
-        // FIX: Added parameter to match implementation
+        // Systematic resampling: one random offset, N evenly spaced pointers
         void resampleParticles(double totalWeight);
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace spectre {
+
+    // Fixed set of worker threads shared by the search engines.
+    // Created once (first use) so a search does not pay for thread start-up every turn.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(int threadCount);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Shared pool, one worker per hardware thread
+        static ThreadPool& instance();
+
+        int size() const { return static_cast<int>(workers.size()); }
+
+        // Runs job(0) .. job(jobs - 1) and returns once all of them finished.
+        // The calling thread runs job(0) itself, so this never stalls on a busy pool.
+        void parallelFor(int jobs, const std::function<void(int)>& job);
+
+        // Fire-and-forget task
+        void submit(std::function<void()> task);
+
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stopping = false;
+
+        void workerLoop();
+    };
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace spectre {
+
+    // ================================================================
+    //                   ENDGAME TRANSPOSITION TABLE
+    // ================================================================
+    // Zobrist key -> (value, bound, depth, best move) for Judge. Lock-free:
+    // each slot is two 64-bit words, the packed data and (key ^ data). A
+    // torn write from another thread fails the key check and reads as a
+    // miss, so no locks and no corrupted hits. Always-replace.
+    class TranspositionTable {
+    public:
+        enum class Bound : uint8_t { NONE = 0, EXACT = 1, LOWER = 2, UPPER = 3 };
+
+        // Move indices are stored in 16 bits; this one is never a real index
+        static constexpr int NO_MOVE = 0xFFFF;
+
+        struct Entry {
+            int value = 0;
+            int depth = 0;          // Plies searched below the node
+            Bound bound = Bound::NONE;
+            int move = NO_MOVE;     // Index of the best move in the node's sorted move list
+            bool complete = false;  // Subtree searched to the end of the game (depth-proof)
+        };
+
+        explicit TranspositionTable(int sizeLog2);
+
+        bool probe(uint64_t key, Entry& out) const;
+        void store(uint64_t key, const Entry& entry);
+        void clear();
+
+        // Shared table of the endgame solver (2^20 slots, 16 MB)
+        static TranspositionTable& endgame();
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> check{0};
+            std::atomic<uint64_t> data{0};
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        uint64_t mask;
+    };
+
+}
@@ -4,14 +4,132 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <cstdint>
 
 namespace spectre {
 
     // Forward declaration since we use references to it
     struct MoveCandidate;
 
+    // ================================================================
+    //                    SUPERLEAVE TABLE
+    // ================================================================
+    // One float per multiset of 0-6 tiles over 27 slots ('A'-'Z', blank).
+    // A leave is indexed through the combinatorial number system: sort its
+    // tiles a0 <= a1 <= ... , make them strictly increasing (b_i = a_i + i)
+    // and rank the combination. No hashing, no collisions, O(tiles).
+    //
+    // File layout: LeaveTableHeader, then LEAVE_TABLE_SIZE little-endian floats.
+    namespace Leaves {
+        constexpr int SLOTS = 27;
+        constexpr int MAX_TILES = 6;
+
+        // C(n, k) for the sizes the index needs
+        constexpr uint32_t binomial(int n, int k) {
+            if (k < 0 || k > n) return 0;
+            uint64_t r = 1;
+            for (int i = 1; i <= k; i++) r = r * (n - k + i) / i;
+            return static_cast<uint32_t>(r);
+        }
+
+        // Multisets of size k over 27 slots = C(27 + k - 1, k)
+        constexpr uint32_t countOfSize(int k) {
+            return binomial(SLOTS + k - 1, k);
+        }
+
+        // First index of each leave size (size 0 = the empty leave at index 0)
+        constexpr uint32_t offsetOfSize(int k) {
+            uint32_t total = 0;
+            for (int j = 0; j < k; j++) total += countOfSize(j);
+            return total;
+        }
+
+        constexpr uint32_t LEAVE_TABLE_SIZE = offsetOfSize(MAX_TILES + 1); // 1,107,568
+
+        // Lookup tables for indexOf (built at compile time)
+        struct IndexTables {
+            uint32_t binom[SLOTS + MAX_TILES][MAX_TILES + 1];
+            uint32_t offset[MAX_TILES + 1];
+        };
+
+        constexpr IndexTables buildIndexTables() {
+            IndexTables t{};
+            for (int n = 0; n < SLOTS + MAX_TILES; n++) {
+                for (int k = 0; k <= MAX_TILES; k++) t.binom[n][k] = binomial(n, k);
+            }
+            for (int k = 0; k <= MAX_TILES; k++) t.offset[k] = offsetOfSize(k);
+            return t;
+        }
+
+        inline constexpr IndexTables INDEX_TABLES = buildIndexTables();
+
+        struct LeaveTableHeader {
+            char magic[4];       // "SLV1"
+            uint32_t maxTiles;   // MAX_TILES
+            uint32_t entryCount; // LEAVE_TABLE_SIZE
+            uint32_t reserved;
+        };
+
+        // Index of a leave histogram (27 counts), or -1 if it holds more than MAX_TILES tiles
+        inline int64_t indexOf(const int* counts) {
+            int64_t rank = 0;
+            int i = 0;
+            for (int slot = 0; slot < SLOTS; slot++) {
+                for (int n = 0; n < counts[slot]; n++) {
+                    if (i == MAX_TILES) return -1;
+                    rank += INDEX_TABLES.binom[slot + i][i + 1];
+                    i++;
+                }
+            }
+            return INDEX_TABLES.offset[i] + rank;
+        }
+    }
+
     class Treasurer {
     public:
+        // --- Superleaves ---
+        // The table is memory-mapped once and shared read-only by every thread.
+        // Only the first load counts (first use loads "superleaves.bin"); without a
+        // table, leaves fall back to the per-letter values of Heuristics::getLeaveValue.
+        static bool loadLeaveTable(const std::string& filename);
+        static bool hasLeaveTable();
+
+        // Value of a leave given as a histogram or a MoveCandidate-style string ('?' = blank)
+        static float leaveValue(const int* counts);
+        static float leaveValue(const char* leave);
+
+        // leaveValue adjusted to this turn's unseen pool (Heuristics::updateWeights on
+        // the calling thread). For the move being decided; playouts use leaveValue.
+        static float turnLeaveValue(const int* counts);
+        static float turnLeaveValue(const char* leave);
+
+        // Writes 'values' (LEAVE_TABLE_SIZE entries) in the table format
+        static bool writeLeaveTable(const std::string& filename, const std::vector<float>& values);
+
+        // --- Expected draw ---
+        // Quality of the rack after 'leave' is refilled from the unseen pool
+        // (27 counts, bagSize tiles left to draw): the fundamental value of the
+        // drawn tiles plus the synergy of the whole rack. Exact over every draw
+        // multiset when there are few of them, stratified sampling otherwise.
+        // Memoized per (leave, pool) on the calling thread, so candidates that keep
+        // the same tiles share one evaluation.
+        struct DrawOutlook {
+            double expected;    // Mean rack quality after the draw
+            double volatility;  // Standard deviation of it
+        };
+
+        static constexpr int EXACT_DRAW_LIMIT = 4096;   // Max draw multisets enumerated exactly
+        static constexpr int DRAW_SAMPLES = 1024;       // Samples when enumeration is too big
+
+        static DrawOutlook drawOutlook(const int* leave, const int* unseen, int bagSize);
+        static double calculateVolatility(const int* leave, const int* unseen, int bagSize);
+
+        // What the draw adds to 'leave' as equity: expected quality minus the
+        // synergy of the leave alone (the kept tiles are valued by leaveValue),
+        // minus the volatility weighted by how much the score situation calls
+        // for safety (getGamma)
+        static double drawEquity(const int* leave, const int* unseen, int bagSize, int scoreDiff);
+
         // Main Valuation Function
         // Returns the Net Asset Value (Equity) of the leave
         // scoreDiff = (MyScore - OppScore). Used to calculate Gamma.
@@ -25,8 +143,7 @@ namespace spectre {
     private:
         // Financial Models
         static double getFundamentalValue(char tile, int bagSize);
-        static double calculateSynergy(const std::vector<char>& tiles);
-        static double calculateVolatility(const std::vector<char>& tiles);
+        static double calculateSynergy(const int* counts);
         static double getGamma(int scoreDiff);
     };
 
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <string>
+#include <cmath>
 
 #include "move_generator.h"
 #include "../move.h"
@@ -11,42 +12,130 @@
 #include "../../include/engine/types.h"
 #include "spy.h"
 #include "profiler.h"
+#include "anytime.h"
 
 namespace spectre {
 
+    // Monte Carlo verdict on one candidate move
+    struct SimResult {
+        MoveCandidate move;
+        int staticEquity = 0;   // One-pass evaluation (score + leave)
+        double mean = 0.0;      // Mean equity over all playouts
+        double stdErr = 0.0;    // Standard error of the mean
+        double winRate = 0.0;   // Mean win probability at the end of the playouts
+        double winStdErr = 0.0;
+        int iterations = 0;
+        bool eliminated = false; // Dropped early: clearly worse than the leader
+
+        // Win chances within this margin are a tie, broken by spread
+        static constexpr double WIN_TIE = 0.005;
+
+        // 95% confidence intervals
+        double ciLow() const { return mean - 1.96 * stdErr; }
+        double ciHigh() const { return mean + 1.96 * stdErr; }
+        double winCiLow() const { return winRate - 1.96 * winStdErr; }
+        double winCiHigh() const { return winRate + 1.96 * winStdErr; }
+
+        // Ranking: win chances first, spread when they are (nearly) equal
+        bool beats(const SimResult& other) const {
+            if (std::abs(winRate - other.winRate) > WIN_TIE) return winRate > other.winRate;
+            return mean > other.mean;
+        }
+    };
+
+    // How far Vanguard::search goes before answering
+    enum class SearchTier {
+        STATIC,     // One-pass equity only
+        LOOKAHEAD,  // + top moves re-ranked by the opponent's best reply
+        SIMULATION  // + Monte Carlo playouts (default)
+    };
+
     class Vanguard {
     public:
+        // Candidates that get simulated (best by static equity)
+        static constexpr int SIM_CANDIDATES = 10;
+        // Plies played out after the candidate (opponent reply + our reply)
+        static constexpr int SIM_PLIES = 2;
+        // Playouts per candidate after which the search stops early
+        static constexpr int SIM_MAX_ITERATIONS = 2000;
+        // Racing: playouts per live candidate per round, and the minimum
+        // sample before a candidate may be dropped
+        static constexpr int SIM_ROUND_PLAYOUTS = 16;
+        static constexpr int SIM_MIN_PLAYOUTS = 48;
+        // Below this win probability defence is dropped to chase points
+        static constexpr float PANIC_WIN_PROB = 0.25f;
+        // 2-ply lookahead: moves re-ranked, and opponent racks tried on each
+        static constexpr int LOOKAHEAD_CANDIDATES = 20;
+        static constexpr int LOOKAHEAD_RACKS = 4;
+        // Share of a newly opened TWS lane's potential charged in the static order
+        static constexpr float DANGER_WEIGHT = 0.5f;
+
         // Update: Now accepts 'const Spy&' instead of 'unseenBag'
         static MoveCandidate search(const LetterBoard &board,
-                                    const Board &bonusBoard,
                                     const TileRack &rack,
                                     Spy &spy,
                                     Dictionary &dict,
                                     int timeLimitMs,
                                     int bagSize,
                                     int scoreDiff,
-                                    OpponentType oppType);
+                                    SearchTier tier = SearchTier::SIMULATION);
+
+        // Anytime form: runs until 'control' says stop and reports the best-so-far
+        // move after every simulation round (see AnytimeSearch).
+        static MoveCandidate search(const LetterBoard &board,
+                                    const TileRack &rack,
+                                    Spy &spy,
+                                    Dictionary &dict,
+                                    SearchControl &control,
+                                    int bagSize,
+                                    int scoreDiff,
+                                    SearchTier tier = SearchTier::SIMULATION);
+
+        // 2-ply static lookahead: plays each candidate (make/unmake on one board per
+        // worker) and finds the opponent's best reply for LOOKAHEAD_RACKS racks from
+        // the Spy, the same racks for every candidate. Returns the mean best reply
+        // score per candidate, in candidate order. Board constraints are built once
+        // per candidate and shared by its racks.
+        static std::vector<double> lookahead(const LetterBoard &board,
+                                             const Spy &spy,
+                                             Dictionary &dict,
+                                             const std::vector<MoveCandidate> &candidates,
+                                             SearchControl &control);
+
+        // Plays the candidates out 'plies' plies deep on the shared thread pool until
+        // 'control' stops it, one move is left or the game is decided either way
+        // (WinModel). Playouts are raced in rounds on win probability: moves whose
+        // confidence interval falls below the leader's are eliminated.
+        // Opponent racks come from the Spy, the bag is the rest of the unseen pool.
+        // Results are in candidate order.
+        static std::vector<SimResult> simulate(const LetterBoard &board,
+                                               const TileRack &rack,
+                                               const Spy &spy,
+                                               Dictionary &dict,
+                                               const std::vector<MoveCandidate> &candidates,
+                                               int scoreDiff,
+                                               SearchControl &control,
+                                               int plies = SIM_PLIES);
 
     private:
-        // Helper to play out a simulation
+        // Helper to play out a simulation: 'plies' greedy moves, opponent first.
+        // Mutates board, racks and bag. Returns the spread from our side plus our leave.
         static int playout(
-            LetterBoard board,
-            const Board& bonusBoard,
+            LetterBoard& board,
             int* myRackCounts,
             int* oppRackCounts,
-            std::vector<char> bag, // passed by value to mutate copy
-            bool myTurn,
+            TileBag& bag,
+            int plies,
             Dictionary& dict
         );
 
         // Helper to calculate score
         static int calculateScore(
             const LetterBoard& board,
-            const Board& bonusBoard,
             const MoveCandidate& move
         );
 
-        // Helper to apply move
+        // Helper to apply move (blanks go on the board in lowercase), returns tiles placed
         static int applyMove(
             LetterBoard& board,
             const MoveCandidate& move,
@@ -54,7 +143,7 @@ namespace spectre {
         );
 
         // Helper to refill rack
-        static void fillRack(int* rackCounts, std::vector<char>& bag);
+        static void fillRack(int* rackCounts, TileBag& bag);
     };
 
-}
\ No newline at end of file
+}
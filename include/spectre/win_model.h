@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace spectre {
+
+    // ================================================================
+    //                    WIN PROBABILITY TABLE
+    // ================================================================
+    // P(win) for one player from (spread, unseen tiles, side to move).
+    // Cells sit every SPREAD_STEP points and UNSEEN_STEP tiles and are
+    // interpolated bilinearly; draws count as half a win. Stored as uint16
+    // (probability * 65535), about 5 KB.
+    //
+    // The table comes from self-play (leaveTrainer writes "winprob.bin").
+    // Without the file a normal model of the remaining spread is used.
+    //
+    // File layout: WinTableHeader, then TABLE_SIZE little-endian uint16.
+    class WinModel {
+    public:
+        static constexpr int SPREAD_MIN = -300;
+        static constexpr int SPREAD_STEP = 10;
+        static constexpr int SPREAD_BINS = 61;      // -300 .. +300
+        static constexpr int UNSEEN_STEP = 5;
+        static constexpr int UNSEEN_BINS = 20;      // 0 .. 95 tiles
+        static constexpr int TABLE_SIZE = 2 * UNSEEN_BINS * SPREAD_BINS;
+
+        // A game is decided once the leader's chances are above this
+        static constexpr float DECIDED = 0.99f;
+
+        struct WinTableHeader {
+            char magic[4];          // "WPT1"
+            uint32_t spreadBins;
+            uint32_t unseenBins;
+            uint32_t reserved;
+        };
+
+        // 'spread' = this player's score minus the opponent's,
+        // 'unseenTiles' = bag + opponent rack as this player sees it
+        static float winProbability(int spread, int unseenTiles, bool onMove);
+
+        // |P - 0.5| big enough that more search will not change the result
+        static bool isDecided(int spread, int unseenTiles, bool onMove);
+
+        // Loads the table once (first use loads "winprob.bin"; later calls are ignored)
+        static bool load(const std::string& filename);
+
+        static bool write(const std::string& filename, const std::vector<uint16_t>& table);
+
+        // Cell layout shared with the trainer
+        static int cellIndex(int onMove, int unseenBin, int spreadBin) {
+            return (onMove * UNSEEN_BINS + unseenBin) * SPREAD_BINS + spreadBin;
+        }
+
+        // Nearest cell of a position (training buckets)
+        static int spreadBin(int spread);
+        static int unseenBin(int unseenTiles);
+
+        // The built-in model, one probability per cell
+        static double priorProbability(int onMove, int unseenBin, int spreadBin);
+    };
+
+}
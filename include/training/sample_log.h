@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// ================================================================
+//                    SELF-PLAY SAMPLE LOGS
+// ================================================================
+// Append-only binary logs of packed uint32 samples, one file per kind:
+//   leave log ("SLOG"): Leaves::indexOf rank of the leave in the low 21 bits,
+//                       future spread (+1024, clamped) in the high 11 bits.
+//   win log   ("WLOG"): spread (+1024, clamped) in bits 0-10, unseen tiles in
+//                       bits 11-17, on move in bit 18, result (0 loss, 1 draw,
+//                       2 win) in bits 19-20.
+//
+// The header holds how many games and samples are complete. It is rewritten
+// after every flush, so bytes past 'samples' (a run killed mid-write) are
+// ignored and overwritten when the log is reopened.
+namespace Training {
+
+    constexpr int INDEX_BITS = 21;
+    constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    constexpr int SPREAD_BIAS = 1024;
+    constexpr int SPREAD_MIN = -SPREAD_BIAS;
+    constexpr int SPREAD_MAX = SPREAD_BIAS - 1;
+
+    struct SampleLogHeader {
+        char magic[4];      // "SLOG" / "WLOG"
+        uint32_t version;
+        uint64_t games;
+        uint64_t samples;
+    };
+
+    constexpr uint32_t packSample(uint32_t leaveIndex, int spread) {
+        if (spread < SPREAD_MIN) spread = SPREAD_MIN;
+        if (spread > SPREAD_MAX) spread = SPREAD_MAX;
+        return (leaveIndex & INDEX_MASK) | (static_cast<uint32_t>(spread + SPREAD_BIAS) << INDEX_BITS);
+    }
+
+    constexpr uint32_t sampleLeave(uint32_t sample) { return sample & INDEX_MASK; }
+    constexpr int sampleSpread(uint32_t sample) { return static_cast<int>(sample >> INDEX_BITS) - SPREAD_BIAS; }
+
+    constexpr uint32_t packPosition(int spread, int unseenTiles, bool onMove, int result) {
+        if (spread < SPREAD_MIN) spread = SPREAD_MIN;
+        if (spread > SPREAD_MAX) spread = SPREAD_MAX;
+        return static_cast<uint32_t>(spread + SPREAD_BIAS) | (static_cast<uint32_t>(unseenTiles & 0x7F) << 11) |
+               (static_cast<uint32_t>(onMove) << 18) | (static_cast<uint32_t>(result & 0x3) << 19);
+    }
+
+    constexpr int positionSpread(uint32_t sample) { return static_cast<int>(sample & 0x7FF) - SPREAD_BIAS; }
+    constexpr int positionUnseen(uint32_t sample) { return static_cast<int>((sample >> 11) & 0x7F); }
+    constexpr bool positionOnMove(uint32_t sample) { return (sample >> 18) & 1; }
+    constexpr int positionResult(uint32_t sample) { return static_cast<int>((sample >> 19) & 0x3); }
+
+    class SampleLog {
+    public:
+        // Opens (or creates) the log for appending. Returns false on an unreadable
+        // file or one of another kind ('magic' = 4 characters).
+        bool open(const std::string& filename, const char* magic);
+
+        // Appends finished games and updates the header
+        bool append(const std::vector<uint32_t>& samples, uint64_t games);
+
+        uint64_t games() const { return header.games; }
+        uint64_t samples() const { return header.samples; }
+
+        // Streams every committed sample through 'visit' (in chunks, the log can be large)
+        template <typename Visit>
+        bool forEach(Visit&& visit);
+
+    private:
+        std::fstream file;
+        SampleLogHeader header{};
+
+        bool writeHeader();
+    };
+
+    template <typename Visit>
+    bool SampleLog::forEach(Visit&& visit) {
+        constexpr uint64_t CHUNK = 1 << 16;
+        std::vector<uint32_t> buffer(CHUNK);
+
+        file.clear();
+        file.seekg(sizeof(SampleLogHeader));
+        uint64_t left = header.samples;
+        while (left > 0) {
+            uint64_t n = (left < CHUNK) ? left : CHUNK;
+            file.read(reinterpret_cast<char*>(buffer.data()), n * sizeof(uint32_t));
+            if (!file) return false;
+            for (uint64_t i = 0; i < n; i++) visit(buffer[i]);
+            left -= n;
+        }
+        return true;
+    }
+}
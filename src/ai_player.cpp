@@ -6,6 +6,7 @@
 #include "../include/engine/dictionary.h"
 #include "../include/modes/PvE/pve.h"
 #include "../include/spectre/judge.h"
+#include "../include/spectre/treasurer.h"
 #include "../include/engine/mechanics.h"
 
 #include <cstring>
@@ -23,21 +24,24 @@ using namespace std::chrono;
 const int SEPERATOR = 26;
 
 // --- CONSTRUCTOR & IDENTITY ---
-AIPlayer::AIPlayer(AIStyle style) : style(style) {}
+AIPlayer::AIPlayer(AIStyle style, int moveTimeMs) : style(style), moveTimeMs(moveTimeMs) {}
 
 string AIPlayer::getName() const {
     return (style == AIStyle::SPEEDI_PI) ? "Speedi_Pi" : "Cutie_Pi";
 }
 
 // --- NEW: WIRE THE BRAIN ---
-void AIPlayer::observeMove(const Move& move, const LetterBoard& board) {
+void AIPlayer::observeMove(const Move& move, const LetterBoard& board, const BlankBoard& blanks) {
     if (style == AIStyle::CUTIE_PI) {
+        // Blanks already down must score zero when the Spy replays the position
+        LetterBoard searchBoard = Mechanics::searchBoard(board, blanks);
+
         // [FIX] Update Profiler FIRST to get the latest analysis
-        profiler.observe(move, board);
+        profiler.observe(move, searchBoard);
 
         // [FIX] Pass the verdict to the Spy
         spectre::OpponentType oppType = profiler.getType();
-        spy.observeOpponentMove(move, board, oppType);
+        spy.observeOpponentMove(move, searchBoard, oppType);
     }
 }
 // --- HELPERS (Keep these for Speedi_Pi and general logic) ---
@@ -92,7 +96,7 @@ string AIPlayer::getTilesToExchange(const TileRack& rack) {
 }
 
 Move AIPlayer::getMove(const GameState& state,
-                       const Board& bonusBoard,
+                       const Board& /*bonusBoard*/,
                        const LastMoveInfo& lastMove,
                        bool canChallenge)
 {
@@ -134,16 +138,17 @@ Move AIPlayer::getMove(const GameState& state,
     // BRAIN 1: SPEEDI_PI (Static Heuristics Only)
     // ---------------------------------------------------------
     if (style == AIStyle::SPEEDI_PI) {
+        // Leave weights for this turn's unseen pool (read per candidate by Treasurer::turnLeaveValue;
+        // Vanguard builds its own on the search thread)
+        Heuristics::updateWeights(state.unseenFor(state.currentPlayerIndex).counts, state.bag.size());
+
         // Direct call to MoveGenerator (No Vanguard class overhead)
         findAllMoves(state.board, state.players[state.currentPlayerIndex].rack);
 
         if (!candidates.empty()) {
             for (auto& cand : candidates) {
-                int boardScore = Mechanics::calculateTrueScore(cand, state.board, bonusBoard);
-                float leavePenalty = 0.0f;
-                for (int i = 0; cand.leave[i] != '\0'; i++) {
-                    leavePenalty += Heuristics::getLeaveValue(cand.leave[i]);
-                }
+                int boardScore = Mechanics::calculateTrueScore(cand, state.board, &state.blanks);
+                float leavePenalty = Treasurer::turnLeaveValue(cand.leave);
                 cand.score = boardScore + (int)leavePenalty;
             }
             // Sort by score
@@ -160,39 +165,36 @@ Move AIPlayer::getMove(const GameState& state,
         const Player& me = state.players[state.currentPlayerIndex];
         const Player& opp = state.players[1 - state.currentPlayerIndex];
 
-        // Update Spy
-        spy.updateGroundTruth(state.board, me.rack, state.bag);
+        // Search board: blanks already down in lowercase, so every score below counts them as zero
+        LetterBoard board = Mechanics::searchBoard(state.board, state.blanks);
+
+        // Update Spy (read-only view of what this player has not seen)
+        spy.updateGroundTruth(state.unseenFor(state.currentPlayerIndex));
 
         // DECISION FORK: ENDGAME vs MIDGAME
         if (state.bag.empty()) {
             // >>> THE JUDGE (Endgame Solver) <<<
-            // We need to infer opponent rack one last time
-            std::vector<char> inferredOpp = spy.generateWeightedRack();
+            // Bag empty: the unseen tiles ARE the opponent's rack (exact mode has one rack)
+            std::vector<char> inferredOpp = spy.likeliestRack();
             TileRack oppRack;
             for(char c : inferredOpp) { Tile t; t.letter=c; t.points=0; oppRack.push_back(t); }
 
-            // Convert Spectre Move to Engine Move directly inside Judge or here
-            Move jMove = Judge::solveEndgame(state.board, bonusBoard, me.rack, oppRack, gDictionary);
-            return jMove;
+            // Searched on its own thread against this player's move clock
+            thinking.start([&](SearchControl& control) {
+                return Judge::searchEndgame(board, me.rack, oppRack, gDictionary,
+                                            me.score - opp.score, control);
+            }, moveTimeMs);
+            bestMove = thinking.result();
         }
         else {
             // >>> THE VANGUARD (Midgame Strategy) <<<
             int scoreDiff = me.score - opp.score;
             int bagSize = state.bag.size();
 
-            spectre::OpponentType oppType = profiler.getType();
-
-            bestMove = Vanguard::search(
-                state.board,
-                bonusBoard,
-                me.rack,
-                spy,
-                gDictionary,
-                3000,
-                bagSize,
-                scoreDiff,
-                oppType //Pass intel to Vanguard
-            );
+            thinking.start([&](SearchControl& control) {
+                return Vanguard::search(board, me.rack, spy, gDictionary, control, bagSize, scoreDiff);
+            }, moveTimeMs);
+            bestMove = thinking.result();
         }
     }
 
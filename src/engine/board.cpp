@@ -1,77 +1,15 @@
 #include <iostream>
 
 #include "../../include/engine/board.h"
+#include "../../include/engine/scoring.h"
 #include "../../include/interface/renderer.h"
 
 using namespace std;
 
-// Building the board and setting up all the bonus squares
+// The bonus layout is built at compile time (see Scoring::BONUS_BOARD),
+// so this just hands out a copy of the constant table.
 Board createBoard() {
-    Board board{};
-
-    //filling everything with normal cells.
-    for (int row = 0; row < BOARD_SIZE; row++) {
-        for (int col = 0; col < BOARD_SIZE; col++) {
-            board[row][col] = CellType::Normal;
-        }
-    }
-
-    // --------------------------------------------------------------
-    // Official Scrabble Bonus Layout
-    // (Row = A–O → 0–14, Col = 1–15 → 0–14)
-    // --------------------------------------------------------------
-
-    // --- Triple Word Score (TWS) ---
-    int tws[][2] = {
-        {0,0},{0,7},{0,14},
-        {7,0},{7,14},
-        {14,0},{14,7},{14,14}
-    };
-
-    for (auto &p : tws) board[p[0]][p[1]] = CellType::TWS;
-
-    //C++ learning note
-    /*
-     * in "for(auto &p : tws)" the p becomes a reference to each element in the list.
-     * each element looks like {row, column}
-     * :tws means for each element inside tws
-     * so p is effectively, first iteration p = {0,0}, second iteration p = {0,7} etc...
-     */
-
-    // --- Double Word Score (DWS) ---
-    // (Note: H7 was already set by you, but including it does no harm)
-    int dws[][2] = {
-        {1,1},{2,2},{3,3},{4,4},{7,7},
-        {10,10},{11,11},{12,12},{13,13},
-        {1,13},{2,12},{3,11},{4,10},
-        {10,4},{11,3},{12,2},{13,1}
-    };
-    for (auto &p : dws) board[p[0]][p[1]] = CellType::DWS;
-
-    // --- Triple Letter Score (TLS) ---
-    int tls[][2] = {
-        {1,5},{1,9},
-        {5,1},{5,5},{5,9},{5,13},
-        {9,1},{9,5},{9,9},{9,13},
-        {13,5},{13,9}
-    };
-    for (auto &p : tls) board[p[0]][p[1]] = CellType::TLS;
-
-    // --- Double Letter Score (DLS) ---
-    int dls[][2] = {
-        {0,3},{0,11},
-        {2,6},{2,8},
-        {3,0},{3,7},{3,14},
-        {6,2},{6,6},{6,8},{6,12},
-        {7,3},{7,11},
-        {8,2},{8,6},{8,8},{8,12},
-        {11,0},{11,7},{11,14},
-        {12,6},{12,8},
-        {14,3},{14,11}
-    };
-    for (auto &p : dls) board[p[0]][p[1]] = CellType::DLS;
-
-    return board;
+    return Scoring::BONUS_BOARD;
 }
 
 // clearing the letter board
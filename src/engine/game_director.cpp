@@ -1,5 +1,6 @@
 #include "../../include/engine/game_director.h"
 #include "../../include/interface/renderer.h"
+#include "../../include/engine/zobrist.h"
 #include "../../include/choices.h" // For extractMainWord/crossWordList helpers
 #include <iostream>
 #include <thread>
@@ -37,9 +38,11 @@ void GameDirector::initGame() {
         drawTiles(state.bag, state.players[i].rack, 7);
     }
     state.currentPlayerIndex = 0;
+    state.hash = Zobrist::compute(state);
+    Mechanics::rebuildUnseen(state);
 
     lastMove.reset();
-    snapshot = state.clone();
+    lastUndo = MoveUndo();
     canChallenge = false;
 }
 
@@ -124,7 +127,7 @@ bool GameDirector::processTurn(int pIdx) {
                 return true;
             }
             // Failure: Offender kept points. Challenger (pIdx) loses turn.
-            state.currentPlayerIndex = 1 - pIdx;
+            Mechanics::setCurrentPlayer(state, 1 - pIdx);
             return true;
         }
     }
@@ -150,19 +153,23 @@ bool GameDirector::processTurn(int pIdx) {
         executePlay(pIdx, move);
     }
 
-    state.currentPlayerIndex = 1 - pIdx;
+    Mechanics::setCurrentPlayer(state, 1 - pIdx);
     return true;
 }
 
 void GameDirector::executePlay(int pIdx, Move& move) {
-    MoveResult result = Referee::validateMove(state, move, bonusBoard, gDictionary);
+    MoveResult result = Referee::validateMove(state, move, gDictionary, config.strictDictionary);
 
     if (result.success) {
-        // 1. Commit Snapshot (Clean state)
-        Mechanics::commitSnapshot(snapshot, state);
+        // 1. NOTIFY OPPONENT (Spy Hook)
+        // Called before the move is applied so the Spy sees the board AS IT WAS
+        // when the move was made (Pre-Move State).
+        int opponentIdx = 1 - pIdx;
+        controllers[opponentIdx]->observeMove(move, state.board, state.blanks);
 
-        // 2. Apply Move (Dirty state)
-        Mechanics::applyMove(state, move, result.score);
+        // 2. Apply Move
+        // The undo record is only needed if the move can still be challenged.
+        Mechanics::applyMove(state, move, result.score, config.allowChallenge ? &lastUndo : nullptr);
 
         // 3. Populate History
         lastMove.exists = true;
@@ -171,19 +178,20 @@ void GameDirector::executePlay(int pIdx, Move& move) {
         lastMove.score = result.score;
         lastMove.emptiedRack = state.players[pIdx].rack.empty();
 
-        // 4. NOTIFY OPPONENT (Spy Hook)
-        // We pass 'snapshot.board' so the Spy sees the board AS IT WAS
-        // when the move was made (Pre-Move State).
-        int opponentIdx = 1 - pIdx;
-        controllers[opponentIdx]->observeMove(move, snapshot.board);
-
         // OPTIMIZATION: Only build word strings if challenges are enabled
         if (config.allowChallenge) {
             lastMove.formedWords.clear();
             string mainWord = extractMainWord(state.board, move.row, move.col, move.horizontal);
             lastMove.formedWords.push_back(mainWord);
 
-            vector<string> crossWords = crossWordList(state.board, snapshot.board, move.row, move.col, move.horizontal);
+            // Pre-move board = current board minus the squares the move filled
+            LetterBoard before = state.board;
+            for (int i = 0; i < lastUndo.placedCount; i++) {
+                int sq = lastUndo.placedSquares[i];
+                before[sq / BOARD_SIZE][sq % BOARD_SIZE] = ' ';
+            }
+
+            vector<string> crossWords = crossWordList(state.board, before, move.row, move.col, move.horizontal);
             lastMove.formedWords.insert(lastMove.formedWords.end(), crossWords.begin(), crossWords.end());
 
             canChallenge = true;
@@ -219,12 +227,13 @@ bool GameDirector::executeChallenge(int challengerIdx) {
     if (invalid) {
         if (config.verbose) log(">>> CHALLENGE SUCCESSFUL! Invalid Word Found.");
 
-        Mechanics::restoreSnapshot(state, snapshot);
+        // Take the move back (tiles, drawn tiles, score, pass count)
+        Mechanics::undoMove(state, lastUndo);
         canChallenge = false;
         lastMove.reset();
 
         // Turn Control: Offender lost turn. Index set to Challenger.
-        state.currentPlayerIndex = challengerIdx;
+        Mechanics::setCurrentPlayer(state, challengerIdx);
         return true;
     } else {
         if (config.verbose) log(">>> CHALLENGE FAILED! Words Valid. (+5 pts to opponent)");
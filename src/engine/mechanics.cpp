@@ -1,6 +1,7 @@
 #include "../../include/engine/mechanics.h"
 #include "../../include/engine/rack.h"
-#include "../../include/heuristics.h"
+#include "../../include/engine/scoring.h"
+#include "../../include/engine/zobrist.h"
 #include "../../include/spectre/move_generator.h"
 #include <iostream>
 #include <vector>
@@ -9,53 +10,169 @@
 using namespace std;
 
 namespace Mechanics {
-    void applyMove(GameState& state, const Move& move, int score) {
+    // Slot a board square counts against in the unseen histograms (blanks count as '?')
+    static int boardSlot(char letter, bool isBlank) {
+        return isBlank ? 26 : Zobrist::slotOf(letter);
+    }
+
+    void applyMove(GameState& state, const Move& move, int score, MoveUndo* undo) {
         int dr = move.horizontal ? 0 : 1;
         int dc = move.horizontal ? 1 : 0;
         int r = move.row;
         int c = move.col;
 
-        TileRack& rack = state.players[state.currentPlayerIndex].rack;
-        string word = move.word;
+        int me = state.currentPlayerIndex;
+        Player& player = state.players[me];
+        TileRack& rack = player.rack;
+
+        // Rack and bag are re-keyed as a whole (they change by several tiles)
+        state.hash ^= Zobrist::rackKey(state.currentPlayerIndex, rack) ^ Zobrist::poolKey(state.bag);
+
+        if (undo) {
+            undo->playerIndex = state.currentPlayerIndex;
+            undo->score = score;
+            undo->prevPassCount = player.passCount;
+            undo->placedCount = 0;
+            undo->drawnCount = 0;
+        }
 
-        for (char letter : word) {
+        for (char letter : move.word) {
             while (r < BOARD_SIZE && c < BOARD_SIZE && state.board[r][c] != ' ') {
                 r += dr; c += dc;
             }
-
-            state.board[r][c] = toupper(letter);
-            state.blanks[r][c] = (letter >= 'a' && letter <= 'z');
+            if (r >= BOARD_SIZE || c >= BOARD_SIZE) break;
 
             // Remove used tile
-            for (auto it = rack.begin(); it != rack.end(); ++it) {
-                bool match = (it->letter == '?') || (toupper(it->letter) == toupper(letter));
-                if (match) {
-                    rack.erase(it);
-                    break;
+            // Exact tile first, then a blank (same preference as the Referee)
+            bool isBlank = (letter >= 'a' && letter <= 'z');
+            int slot = rack.find(letter);
+            if (slot == -1) slot = rack.find('?');
+            if (slot != -1) {
+                isBlank = (rack[slot].letter == '?');
+                if (undo) {
+                    undo->removedTiles[undo->placedCount] = rack[slot];
+                    undo->removedSlots[undo->placedCount] = static_cast<uint8_t>(slot);
                 }
+                rack.erase(rack.begin() + slot);
+            }
+
+            state.board[r][c] = static_cast<char>(toupper(static_cast<unsigned char>(letter)));
+            state.blanks[r][c] = isBlank;
+            state.hash ^= Zobrist::squareKey(r, c, state.board[r][c], isBlank);
+
+            // The tile is now public: the opponent has seen it. For the mover it only
+            // moved from rack to board, unless it never came from the rack.
+            int seen = boardSlot(state.board[r][c], isBlank);
+            if (seen >= 0) {
+                state.unseen.add(1 - me, seen, -1);
+                if (slot == -1) state.unseen.add(me, seen, -1);
+            }
+
+            if (undo) {
+                // A slot of 0xFF marks a tile that was not found in the rack
+                if (slot == -1) undo->removedSlots[undo->placedCount] = 0xFF;
+                undo->placedSquares[undo->placedCount++] = static_cast<uint8_t>(r * BOARD_SIZE + c);
             }
             r += dr; c += dc;
         }
 
-        state.players[state.currentPlayerIndex].score += score;
-        state.players[state.currentPlayerIndex].passCount = 0; // Valid move resets pass count
+        player.score += score;
+        player.passCount = 0; // Valid move resets pass count
 
         if (rack.size() < 7 && !state.bag.empty()) {
-            drawTiles(state.bag, rack, static_cast<int>(7 - rack.size()));
+            int drawn = drawTiles(state.bag, rack, static_cast<int>(7 - rack.size()));
+            if (undo) undo->drawnCount = drawn;
+
+            // Drawn tiles land at the end of the rack and are now seen by the mover
+            for (int i = rack.size() - drawn; i < static_cast<int>(rack.size()); i++) {
+                state.unseen.add(me, Zobrist::slotOf(rack[i].letter), -1);
+            }
         }
+
+        state.hash ^= Zobrist::rackKey(state.currentPlayerIndex, rack) ^ Zobrist::poolKey(state.bag);
     }
 
-    void commitSnapshot(GameState& backup, const GameState& current) {
-        backup = current;
+    void undoMove(GameState& state, const MoveUndo& undo) {
+        Player& player = state.players[undo.playerIndex];
+        TileRack& rack = player.rack;
+
+        state.hash ^= Zobrist::rackKey(undo.playerIndex, rack) ^ Zobrist::poolKey(state.bag);
+
+        // 1. Return drawn tiles to the bag
+        for (int i = 0; i < undo.drawnCount; i++) {
+            state.unseen.add(undo.playerIndex, Zobrist::slotOf(rack.back().letter), 1);
+            state.bag.push_back(rack.back());
+            rack.pop_back();
+        }
+
+        // 2. Lift placed tiles and put them back into their rack slots (reverse order)
+        for (int i = undo.placedCount - 1; i >= 0; i--) {
+            int sq = undo.placedSquares[i];
+            int r = sq / BOARD_SIZE;
+            int c = sq % BOARD_SIZE;
+            state.hash ^= Zobrist::squareKey(r, c, state.board[r][c], state.blanks[r][c]);
+
+            int seen = boardSlot(state.board[r][c], state.blanks[r][c]);
+            if (seen >= 0) {
+                state.unseen.add(1 - undo.playerIndex, seen, 1);
+                if (undo.removedSlots[i] == 0xFF) state.unseen.add(undo.playerIndex, seen, 1);
+            }
+
+            state.board[r][c] = ' ';
+            state.blanks[r][c] = false;
+
+            if (undo.removedSlots[i] != 0xFF) {
+                rack.insert(rack.begin() + undo.removedSlots[i], undo.removedTiles[i]);
+            }
+        }
+
+        state.hash ^= Zobrist::rackKey(undo.playerIndex, rack) ^ Zobrist::poolKey(state.bag);
+
+        // 3. Score & pass bookkeeping
+        player.score -= undo.score;
+        player.passCount = undo.prevPassCount;
     }
 
-    void restoreSnapshot(GameState& current, const GameState& backup) {
-        current = backup;
+    void setCurrentPlayer(GameState& state, int playerIdx) {
+        if (state.currentPlayerIndex != playerIdx) {
+            state.hash ^= Zobrist::KEYS.sideToMove;
+            state.currentPlayerIndex = playerIdx;
+        }
+    }
+
+    void rebuildUnseen(GameState& state) {
+        // Unseen for a player = bag + opponent's rack
+        for (int p = 0; p < 2; p++) {
+            int bagCounts[TileBag::SLOTS];
+            int rackCounts[TileBag::SLOTS];
+            state.bag.fillCounts(bagCounts);
+            state.players[1 - p].rack.fillCounts(rackCounts);
+
+            for (int i = 0; i < TileBag::SLOTS; i++) {
+                state.unseen.counts[p][i] = static_cast<uint8_t>(bagCounts[i] + rackCounts[i]);
+            }
+            state.unseen.total[p] = static_cast<int>(state.bag.size() + state.players[1 - p].rack.size());
+        }
     }
 
     bool attemptExchange(GameState& state, const Move& move) {
-        Player& p = state.players[state.currentPlayerIndex];
+        int me = state.currentPlayerIndex;
+        Player& p = state.players[me];
+        uint64_t before = Zobrist::rackKey(me, p.rack) ^ Zobrist::poolKey(state.bag);
+
+        int oldCounts[TileBag::SLOTS];
+        p.rack.fillCounts(oldCounts);
+
         if (exchangeRack(p.rack, move.exchangeLetters, state.bag)) {
+            state.hash ^= before ^ Zobrist::rackKey(me, p.rack) ^ Zobrist::poolKey(state.bag);
+
+            // Returned tiles become unseen again, drawn ones are now seen
+            int newCounts[TileBag::SLOTS];
+            p.rack.fillCounts(newCounts);
+            for (int i = 0; i < TileBag::SLOTS; i++) {
+                if (oldCounts[i] != newCounts[i]) state.unseen.add(me, i, oldCounts[i] - newCounts[i]);
+            }
+
             // RULE: Exchanges increase the pass count (effectively using a turn)
             p.passCount++;
             return true;
@@ -85,95 +202,24 @@ namespace Mechanics {
         state.players[winnerIdx].score += (loserRackVal * 2);
     }
 
-    // Helper to calculate score for a specific move
-int calculateTrueScore(const spectre::MoveCandidate &move, const LetterBoard& letters, const Board &bonusBoard) {
-
-    int totalScore = 0;
-    int mainWordScore = 0;
-    int mainWordMultiplier = 1;
-    int tilesPlacedCount = 0;
-
-    int r = move.row;
-    int c = move.col;
-    int dr = move.isHorizontal ? 0 : 1;
-    int dc = move.isHorizontal ? 1 : 0;
-
-    for (char letter : move.word) {
-        if (letter == '\0') break;
-
-        if (r < 0 || r > 14 || c < 0 || c > 14) return -1000;
-
-        int letterScore = spectre::Heuristics::getTileValue(letter);
-        bool isNewlyPlaced = (letters[r][c] == ' ');
-
-        if (isNewlyPlaced) {
-            tilesPlacedCount++;
-            CellType bonus = bonusBoard[r][c];
-
-            if (bonus == CellType::DLS) letterScore *= 2;
-            else if (bonus == CellType::TLS) letterScore *= 3;
-
-            if (bonus == CellType::DWS) mainWordMultiplier *= 2;
-            else if (bonus == CellType::TWS) mainWordMultiplier *= 3;
-        }
-
-        mainWordScore += letterScore;
-
-        if (isNewlyPlaced) {
-            int pdr = move.isHorizontal ? 1 : 0;
-            int pdc = move.isHorizontal ? 0 : 1;
-            bool hasNeighbour = false;
-
-            int checkR1 = r - pdr;
-            int checkC1 = c - pdc;
-            if (checkR1 >= 0 && checkR1 < 15 && checkC1 >= 0 && checkC1 < 15 && letters[checkR1][checkC1] != ' ') hasNeighbour = true;
-
-            int checkR2 = r + pdr;
-            int checkC2 = c + pdc;
-            if (checkR2 >= 0 && checkR2 < 15 && checkC2 >= 0 && checkC2 < 15 && letters[checkR2][checkC2] != ' ') hasNeighbour = true;
-
-            if (hasNeighbour) {
-                int currR = r, currC = c;
-                while (currR - pdr >= 0 && currC - pdc >= 0 && letters[currR-pdr][currC-pdc] != ' ') {
-                    currR -= pdr;
-                    currC -= pdc;
-                }
-
-                int crossScore = 0;
-                int crossMult = 1;
-
-                while (currR < 15 && currC < 15) {
-                    char cellLetter = letters[currR][currC];
-                    if (currR == r && currC == c) {
-                        int crossLetterScore = spectre::Heuristics::getTileValue(letter);
-                        CellType crossBonus = bonusBoard[currR][currC];
-                        if (crossBonus == CellType::DLS) crossLetterScore *= 2;
-                        else if (crossBonus == CellType::TLS) crossLetterScore *= 3;
-                        if (crossBonus == CellType::DWS) crossMult *= 2;
-                        else if (crossBonus == CellType::TWS) crossMult *= 3;
-                        crossScore += crossLetterScore;
-                    } else if (cellLetter != ' ') {
-                        crossScore += spectre::Heuristics::getTileValue(cellLetter);
-                    } else {
-                        break;
-                    }
-                    currR += pdr;
-                    currC += pdc;
-                }
-                totalScore += (crossScore * crossMult);
+    // Copy of the board with blank tiles written in lowercase
+    LetterBoard searchBoard(const LetterBoard& letters, const BlankBoard& blanks) {
+        LetterBoard board = letters;
+        for (int r = 0; r < BOARD_SIZE; r++) {
+            for (int c = 0; c < BOARD_SIZE; c++) {
+                if (blanks[r][c]) board[r][c] = static_cast<char>(tolower(static_cast<unsigned char>(board[r][c])));
             }
         }
-        r += dr;
-        c += dc;
+        return board;
     }
 
-    if (strlen(move.word) > 1) {
-        totalScore += (mainWordScore * mainWordMultiplier);
-    }
-    if (tilesPlacedCount == 7) {
-        totalScore += 50;
+    // Scores a generated candidate with the shared kernel.
+    // Blanks come through as lowercase letters in 'move.word'.
+    int calculateTrueScore(const spectre::MoveCandidate &move, const LetterBoard& letters, const BlankBoard* blanks) {
+        Scoring::Placement placement;
+        if (!Scoring::placementFromWord(letters, move.row, move.col, move.isHorizontal, move.word, placement)) {
+            return -1000;
+        }
+        return Scoring::scorePlacement(letters, blanks, placement);
     }
-
-    return totalScore;
-}
 }
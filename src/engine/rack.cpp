@@ -1,5 +1,6 @@
 #include "../../include/engine/rack.h"
 #include "../../include/engine/tiles.h"
+#include "../../include/engine/scoring.h"
 
 #include <iostream>
 #include <algorithm>
@@ -12,14 +13,24 @@ using namespace std;
 // Returns how many tiles were actually drawn.
 int drawTiles(TileBag &bag, TileRack &rack, int count) {
     int drawn = 0;
-    while (drawn < count && !bag.empty()) {
-        rack.push_back(bag.back()); // take from end
-        bag.pop_back();
+    while (drawn < count && !bag.empty() && !rack.full()) {
+        rack.push_back(bag.draw()); // random tile
         ++drawn;
     }
     return drawn;
 }
 
+TileRack rackFromCounts(const int *counts) {
+    TileRack rack;
+    for (int slot = 0; slot < 27; slot++) {
+        Tile t;
+        t.letter = (slot == 26) ? '?' : static_cast<char>('A' + slot);
+        t.points = Scoring::letterValue(t.letter);
+        for (int k = 0; k < counts[slot]; k++) rack.push_back(t);
+    }
+    return rack;
+}
+
 //Swap two tiles in the rack (based on player view)
 bool handleSwapCommand(TileRack &rack, int index1, int index2) {
 
@@ -54,8 +65,8 @@ bool exchangeRack(TileRack &rack, const string& lettersStr, TileBag &bag) {
         bool found = false;
 
         // C++ Learning
-        // tempRack.begin() returns vector<Tile>::iterator
-        // And a vector iterator behaves exactly like a pointer to an element.
+        // tempRack.begin() returns TileRack::iterator, which is a plain Tile*
+        // (the rack stores its tiles inline), so it behaves exactly like a pointer.
         for (auto it = tempRack.begin(); it != tempRack.end(); ++it) {
             char rackCh = static_cast<char>(toupper(static_cast<unsigned char>((*it).letter)));
             if (rackCh == ch) {
@@ -76,11 +87,10 @@ bool exchangeRack(TileRack &rack, const string& lettersStr, TileBag &bag) {
     // All requested letters are found.
     rack = tempRack;
 
-    // Put removed tiles back into the bag
-    bag.insert(bag.end(), removed.begin(), removed.end());
-
-    //shuffle the bag
-    shuffleTileBag(bag);
+    // Put removed tiles back into the bag (draws are random, no shuffle needed)
+    for (const Tile &t : removed) {
+        bag.push_back(t);
+    }
 
     // Draw the same number of tiles back
     drawTiles(bag, rack, static_cast<int>(removed.size()));
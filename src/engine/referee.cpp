@@ -1,5 +1,6 @@
 #include "../../include/engine/referee.h"
 #include "../../include/engine/rack.h"
+#include "../../include/engine/scoring.h"
 #include <algorithm>
 #include <cctype>
 
@@ -18,36 +19,10 @@ static string toUpper(const string &s) {
     return r;
 }
 
-// Letter -> points
-// This is needed because the board stores only chars, not Tile objects
-static int letterPoints(char ch) {
-    ch = static_cast<char>(toupper(static_cast<unsigned char>(ch)));
-
-    switch (ch) {
-        case 'A': case 'E': case 'I': case 'O': case 'U':
-        case 'N': case 'R': case 'T': case 'L': case 'S':
-            return 1;
-        case 'D': case 'G':
-            return 2;
-        case 'B': case 'C': case 'M': case 'P':
-            return 3;
-        case 'F': case 'H': case 'V': case 'W': case 'Y':
-            return 4;
-        case 'K':
-            return 5;
-        case 'J': case 'X':
-            return 8;
-        case 'Q': case 'Z':
-            return 10;
-        default:
-            return 0;
-    }
-}
-
 // Finding a tile in the rack that can represent a letter.
 // Use a blank ? if the exact letter is not in the rack.
 // 'used' marks tiles that are already consumed for this move.
-static int findTilesForLetter(const TileRack &rack, const vector<bool> &used, char letter) {
+static int findTilesForLetter(const TileRack &rack, const bool *used, char letter) {
 
     char upper = static_cast<char>(toupper(static_cast<unsigned char>(letter)));
 
@@ -70,177 +45,107 @@ static int findTilesForLetter(const TileRack &rack, const vector<bool> &used, ch
     return -1;
 }
 
-// Score the main word that includes the square at (anchorRow,anchorCol)
-// newTile[r][c] is true if that tile was placed this turn.
-static int scoreMainWord(const Board &bonusBoard, const LetterBoard &letters, const BlankBoard &blanks,
-                        bool newTile[BOARD_SIZE][BOARD_SIZE], int anchorRow, int anchorCol, bool horizontal) {
-    int dr = horizontal ? 0 : 1;
-    int dc = horizontal ? 1 : 0;
+// GADDAG edge index of a board/placement letter (blanks are stored uppercase)
+static int letterIndex(char letter) {
+    return toupper(static_cast<unsigned char>(letter)) - 'A';
+}
 
-    // Step backwards to find the true start of the word.
-    int r = anchorRow;
-    int c = anchorCol;
+bool Referee::checkWords(const LetterBoard &letters, const Scoring::Placement &placement, const Dictionary &dict) {
+    if (placement.count == 0) return false;
 
-    // finding the start of the formed word.
-    while (true) {
-        int pr = r - dr;
-        int pc = c - dc;
-        if (pr < 0 || pr >= BOARD_SIZE || pc < 0 || pc >= BOARD_SIZE) {
-            break;
-        }
-        if (letters[pr][pc] == ' ') break;
+    const int SEPERATOR = 26;
+    int dr = placement.horizontal ? 0 : 1;
+    int dc = placement.horizontal ? 1 : 0;
 
-        //True start of the word (letters[r][c])
-        r = pr;
-        c = pc;
+    // 1. Main word: back up to its true start, then walk it once through the GADDAG
+    // as  first letter -> separator -> rest of the word.
+    int r = placement.tiles[0].row;
+    int c = placement.tiles[0].col;
+    while (r - dr >= 0 && c - dc >= 0 && letters[r - dr][c - dc] != ' ') {
+        r -= dr;
+        c -= dc;
     }
 
-    int totalLetterScore = 0;
-    int wordMultiplier = 1;
-
-    // Walking forward, until we hit an empty squre
-    while (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE && letters[r][c] != ' ') {
-
-        char ch = letters[r][c];
-
-        // No letter score if its a blank.
-        int base = blanks[r][c] ? 0 : letterPoints(ch);
-        int letterScore = base;
+    int node = dict.rootIndex;
+    int mainLength = 0;
+    int next = 0;
 
-        if (newTile[r][c]) {
-            CellType cell = bonusBoard[r][c];
-
-            // Letter multiplier only affect the newly placed non-blank tiles.
-            if (!blanks[r][c]) {
-                if (cell == CellType::DLS) {
-                    letterScore *= 2;
-                }
-                if (cell == CellType::TLS) {
-                    letterScore *= 3;
-                }
-            }
-
-            // Word multipliers only count if a new tile is on them
-            if (cell == CellType::DWS) {
-                wordMultiplier *= 2;
-            }
-            if (cell == CellType::TWS) {
-                wordMultiplier *= 3;
-            }
+    while (r < BOARD_SIZE && c < BOARD_SIZE) {
+        char letter;
+        if (next < placement.count && placement.tiles[next].row == r && placement.tiles[next].col == c) {
+            letter = placement.tiles[next++].letter;
+        } else if (letters[r][c] != ' ') {
+            letter = letters[r][c];
+        } else {
+            break;
         }
 
-        totalLetterScore += letterScore;
+        // (keep walking after a dead end so the whole word is still measured)
+        if (node != -1) node = dict.getChild(node, letterIndex(letter));
+        if (node != -1 && mainLength == 0) node = dict.getChild(node, SEPERATOR);
 
+        ++mainLength;
         r += dr;
         c += dc;
     }
 
-    return (totalLetterScore * wordMultiplier);
-}
-
-// Score a cross word created by placing a tile at (anchorRow, anchorCol)
-// mainHorizontal = orientation of the MAIN word; cross is perpendicular.
-static int scoreCrossWord(const Board &bonusBoard, const LetterBoard &letters, const BlankBoard &blanks,
-                        bool newTile[BOARD_SIZE][BOARD_SIZE], int anchorRow, int anchorCol, bool mainHorizontal) {
-    // perpendicular direction
-    int dr = mainHorizontal ? 1 : 0;
-    int dc = mainHorizontal ? 0 : 1;
-
-    int r = anchorRow;
-    int c = anchorCol;
-
-    // First check if there is any neighbor in that perpendicular direction
-    bool hasNeighbor = false;
-
-    // checking either side
-    int nr = r - dr;
-    int nc = c - dc;
-    if (nr >= 0 && nr < BOARD_SIZE && nc >= 0 && nc < BOARD_SIZE && letters[nr][nc] !=' ') {
-        hasNeighbor = true;
-    }
-
-    nr = r + dr;
-    nc = c + dc;
-    if (!hasNeighbor && nr >= 0 && nr < BOARD_SIZE && nc >= 0 && nc < BOARD_SIZE && letters[nr][nc] !=' ') {
-        hasNeighbor = true;
-    }
+    // Every placed tile must sit inside the main word (no gaps)
+    if (next != placement.count) return false;
 
-    // Single tile with no adjacent letter in cross direction
-    if (!hasNeighbor) {
-        return 0;
+    bool formedWord = false;
+    if (mainLength > 1) {
+        if (node == -1 || !dict.nodes[node].isEndOfWord) return false;
+        formedWord = true;
     }
 
-    // Back up to the start of the cross word
-    r = anchorRow;
-    c = anchorCol;
-
-    while (true) {
-        int pr = r - dr;
-        int pc = c - dc;
-        if (pr < 0 || pr >= BOARD_SIZE || pc < 0 || pc >= BOARD_SIZE) {
-            break;
+    // 2. Cross words: each placed tile is the only new letter of its perpendicular
+    // word, walked through the GADDAG the same way as the main word.
+    for (int i = 0; i < placement.count; i++) {
+        const Scoring::PlacedTile &tile = placement.tiles[i];
+        int pr = tile.row - dc, pc = tile.col - dr; // before, perpendicular
+        int nr = tile.row + dc, nc = tile.col + dr; // after, perpendicular
+
+        bool hasBefore = (pr >= 0 && pc >= 0 && letters[pr][pc] != ' ');
+        bool hasAfter = (nr < BOARD_SIZE && nc < BOARD_SIZE && letters[nr][nc] != ' ');
+        if (!hasBefore && !hasAfter) continue;
+
+        // Back up to the cross word's start
+        int cr = tile.row, cc = tile.col;
+        while (cr - dc >= 0 && cc - dr >= 0 && letters[cr - dc][cc - dr] != ' ') {
+            cr -= dc;
+            cc -= dr;
         }
-        if (letters[pr][pc] == ' ') {
-            break;
-        }
-
-        // start of the cross word.
-        r = pr;
-        c = pc;
-    }
-
-    int totalLetterScore = 0;
-    int wordMultiplier = 1;
-    int length = 0;
-
-    // Walk forward along the cross-word direction
-    while (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE && letters[r][c] != ' ') {
-
-        ++length;
-
-        char ch = letters[r][c];
-        int base = blanks[r][c] ? 0 : letterPoints(ch);
-        int letterScore = base;
 
-        if (newTile[r][c]) {
-            CellType cell = bonusBoard[r][c];
-
-            if (!blanks[r][c]) {
-                if (cell == CellType::DLS) {
-                    letterScore *= 2;
-                }else if (cell == CellType::TLS) {
-                    letterScore *= 3;
-                }
-            }
-
-            if (cell == CellType::DWS) {
-                wordMultiplier *= 2;
-            } else if (cell == CellType::TWS) {
-                wordMultiplier *= 3;
-            }
+        int crossNode = dict.rootIndex;
+        bool first = true;
+        while (crossNode != -1 && cr < BOARD_SIZE && cc < BOARD_SIZE) {
+            char letter;
+            if (cr == tile.row && cc == tile.col) letter = tile.letter;
+            else if (letters[cr][cc] != ' ') letter = letters[cr][cc];
+            else break;
+
+            crossNode = dict.getChild(crossNode, letterIndex(letter));
+            if (crossNode != -1 && first) crossNode = dict.getChild(crossNode, SEPERATOR);
+            first = false;
+            cr += dc;
+            cc += dr;
         }
-
-        totalLetterScore += letterScore;
-        r += dr;
-        c += dc;
-    }
-
-    if (length <= 1) {
-        // safety: no real cross-words formed
-        return 0;
+        if (crossNode == -1 || !dict.nodes[crossNode].isEndOfWord) return false;
+        formedWord = true;
     }
 
-    return totalLetterScore * wordMultiplier;
+    // A lone tile with no neighbours forms no word at all
+    return formedWord;
 }
 
-MoveResult Referee::validateMove(const GameState &state, const Move &move, const Board &bonusBoard, Dictionary &dict) {
+MoveResult Referee::validateMove(const GameState &state, const Move &move, Dictionary &dict,
+                                 bool strictDictionary) {
     MoveResult res{};
     res.success = false;
     res.score = 0;
 
-    LetterBoard letters = state.board;
-    BlankBoard blanks = state.blanks;
-    TileRack rack = state.players[state.currentPlayerIndex].rack;
+    const LetterBoard &letters = state.board;
+    const TileRack &rack = state.players[state.currentPlayerIndex].rack;
 
     // Map the 'Move' struct to the old variable names
     int startRow = move.row;
@@ -277,10 +182,8 @@ MoveResult Referee::validateMove(const GameState &state, const Move &move, const
 
     vector < NewTile > newTiles;
 
-    // C++ Learning
-    // vector<bool> usedRack(rack.size(), false); means create a vector(dynamic array) with rack.size() number
-    //-of elements, and initialize ALL of them to false.
-    vector<bool> usedRack(rack.size(), false);
+    // Marks rack slots already consumed by this move (racks hold at most 7 tiles)
+    bool usedRack[TileRack::CAPACITY] = {false};
 
     int r = startRow;
     int c = startCol;
@@ -421,67 +324,23 @@ MoveResult Referee::validateMove(const GameState &state, const Move &move, const
         }
     }
 
-    // Place the letters on the board
-    bool newTile[BOARD_SIZE][BOARD_SIZE] = {false};
-
+    // Score main word + cross words + bingo with the shared kernel
+    Scoring::Placement placement;
+    placement.horizontal = horizontal;
     for (const auto &nt : newTiles) {
-        letters[nt.row][nt.col] = nt.letter;
-        blanks[nt.row][nt.col] = nt.isBlank;
-        newTile[nt.row][nt.col] = true;
+        placement.add(nt.row, nt.col, nt.letter, nt.isBlank);
     }
 
-    // Score the main word
-    int mainScore = scoreMainWord(
-        bonusBoard,
-        letters,
-        blanks,
-        newTile,
-        startRow,
-        startCol,
-        horizontal
-    );
-
-    // Score all cross-words created by each newly placed tile
-    int crossScore = 0;
-    for (const auto &nt : newTiles) {
-        crossScore += scoreCrossWord(
-            bonusBoard,
-            letters,
-            blanks,
-            newTile,
-            nt.row,
-            nt.col,
-            horizontal
-        );
+    // Strict games reject phonies up front instead of waiting for a challenge
+    if (strictDictionary && !checkWords(letters, placement, dict)) {
+        res.message = "Move forms a word that is not in the dictionary";
+        return res;
     }
 
-    int totalScore = mainScore + crossScore;
-
-    // Bingo: if 7 tiles used from the rack +50 bonus points
-    int tilesUsedFromRack = 0;
-    for (bool used: usedRack) {
-        if (used) ++tilesUsedFromRack;
-    }
-    if (tilesUsedFromRack == 7) {
-        totalScore += 50;
-    }
+    int totalScore = Scoring::scorePlacement(letters, &state.blanks, placement);
 
     res.success = true;
     res.score = totalScore;
 
-    // Remove used tiles from the rack (erasing from the back to keep indices valid
-    vector<int> usedIndices;
-    for (int i = 0; i < static_cast<int>(usedRack.size()); i++) {
-        if (usedRack[i]) {
-            usedIndices.push_back(i);
-        }
-    }
-
-    //this sores vector usedIndices in descending order
-    sort(usedIndices.begin(), usedIndices.end(), greater<int>());
-    for (int idx: usedIndices) {
-        rack.erase(rack.begin() + idx);
-    }
-
     return res;
 }
\ No newline at end of file
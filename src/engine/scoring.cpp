@@ -0,0 +1,125 @@
+#include "../../include/engine/scoring.h"
+
+#include <cctype>
+
+using namespace std;
+
+namespace Scoring {
+
+    bool placementFromWord(const LetterBoard &letters, int row, int col, bool horizontal,
+                           const char *word, Placement &out) {
+        int dr = horizontal ? 0 : 1;
+        int dc = horizontal ? 1 : 0;
+        int r = row;
+        int c = col;
+
+        out.count = 0;
+        out.horizontal = horizontal;
+
+        for (int i = 0; word[i] != '\0'; i++) {
+            if (r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE) return false;
+
+            // Squares already on the board are part of the word but not of the placement
+            if (letters[r][c] == ' ') {
+                char letter = word[i];
+                bool isBlank = (letter >= 'a' && letter <= 'z');
+                out.add(r, c, static_cast<char>(toupper(static_cast<unsigned char>(letter))), isBlank);
+            }
+            r += dr;
+            c += dc;
+        }
+        return true;
+    }
+
+    int scorePlacement(const LetterBoard &letters, const BlankBoard *blanks, const Placement &placement) {
+        if (placement.count == 0) return 0;
+
+        // Value of a tile that was already on the board (no premiums)
+        auto boardValue = [&](int r, int c) {
+            if (blanks && (*blanks)[r][c]) return 0;
+            return letterValue(letters[r][c]);
+        };
+
+        int dr = placement.horizontal ? 0 : 1;
+        int dc = placement.horizontal ? 1 : 0;
+        int totalScore = 0;
+
+        // 1. Main word: back up to its true start, then walk forward over
+        // existing letters and placed tiles until the line breaks.
+        int r = placement.tiles[0].row;
+        int c = placement.tiles[0].col;
+        while (r - dr >= 0 && c - dc >= 0 && letters[r - dr][c - dc] != ' ') {
+            r -= dr;
+            c -= dc;
+        }
+
+        int mainScore = 0;
+        int mainMultiplier = 1;
+        int mainLength = 0;
+        int next = 0;
+
+        while (r < BOARD_SIZE && c < BOARD_SIZE) {
+            if (next < placement.count && placement.tiles[next].row == r && placement.tiles[next].col == c) {
+                const PlacedTile &tile = placement.tiles[next++];
+                int value = tile.isBlank ? 0 : letterValue(tile.letter);
+                mainScore += value * LETTER_MULT[r][c];
+                mainMultiplier *= WORD_MULT[r][c];
+            } else if (letters[r][c] != ' ') {
+                mainScore += boardValue(r, c);
+            } else {
+                break;
+            }
+            ++mainLength;
+            r += dr;
+            c += dc;
+        }
+
+        // A single tile only scores through its cross word
+        if (mainLength > 1) {
+            totalScore += mainScore * mainMultiplier;
+        }
+
+        // 2. Cross words: each placed tile is the only new tile in its perpendicular line.
+        int pdr = dc;
+        int pdc = dr;
+
+        for (int i = 0; i < placement.count; i++) {
+            const PlacedTile &tile = placement.tiles[i];
+
+            r = tile.row;
+            c = tile.col;
+            while (r - pdr >= 0 && c - pdc >= 0 && letters[r - pdr][c - pdc] != ' ') {
+                r -= pdr;
+                c -= pdc;
+            }
+
+            int crossScore = 0;
+            int crossLength = 0;
+
+            while (r < BOARD_SIZE && c < BOARD_SIZE) {
+                if (r == tile.row && c == tile.col) {
+                    int value = tile.isBlank ? 0 : letterValue(tile.letter);
+                    crossScore += value * LETTER_MULT[r][c];
+                } else if (letters[r][c] != ' ') {
+                    crossScore += boardValue(r, c);
+                } else {
+                    break;
+                }
+                ++crossLength;
+                r += pdr;
+                c += pdc;
+            }
+
+            if (crossLength > 1) {
+                totalScore += crossScore * WORD_MULT[tile.row][tile.col];
+            }
+        }
+
+        // 3. Bingo
+        if (placement.count == BINGO_SIZE) {
+            totalScore += BINGO_BONUS;
+        }
+
+        return totalScore;
+    }
+}
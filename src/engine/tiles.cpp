@@ -1,11 +1,12 @@
 #include "../../include/engine/tiles.h"
 #include "../../include/engine/rack.h"
+#include "../../include/engine/scoring.h"
 
 #include <iostream>
 #include <vector>
 #include <algorithm>
 #include <random>
-#include <ctime>
+#include <atomic>
 
 using namespace std;
 
@@ -16,15 +17,13 @@ TileBag createStandardTileBag() {
         [&bag] means the lambda wants to acces to the variable bag and it wants access by reference.
         so the lambda can modify the baf directly.
         letter -> The letter to be added
-        points -> The number of points the tile is worth
         count -> How many of those tiles to be added
-        ex: addTiles('A', 1, 9) means 9 tiles of letter A each worth 1 point are added to the bag.
-        bag.push_back(Tile{'A', 1}); x 9 times
+        ex: addTiles('A', 9) means 9 tiles of letter A are added to the bag.
+        bag.add('A', 9); (the bag only keeps counts)
      */
-    auto addTiles = [&bag](char letter, int points, int count) {
-        for (int i = 0; i < count; i++) {
-            bag.push_back(Tile{letter, points});
-        }
+    // (points are implied by the letter, see Scoring::LETTER_VALUES)
+    auto addTiles = [&bag](char letter, int count) {
+        bag.add(letter, count);
     };
 
     // Letter distribution:
@@ -32,53 +31,111 @@ TileBag createStandardTileBag() {
     // B,C,M,P,F,H,V,W,Y×2; K,J,X,Q,Z×1; blanks×2
 
     //1-point letters
-    addTiles('E', 1, 12);
-    addTiles('A', 1, 9);
-    addTiles('I', 1,  9);
-    addTiles('O', 1,  8);
-    addTiles('N', 1,  6);
-    addTiles('R', 1,  6);
-    addTiles('T', 1,  6);
-    addTiles('L', 1,  4);
-    addTiles('S', 1,  4);
-    addTiles('U', 1,  4);
+    addTiles('E', 12);
+    addTiles('A', 9);
+    addTiles('I', 9);
+    addTiles('O', 8);
+    addTiles('N', 6);
+    addTiles('R', 6);
+    addTiles('T', 6);
+    addTiles('L', 4);
+    addTiles('S', 4);
+    addTiles('U', 4);
 
     // 2-point letters
-    addTiles('D', 2, 4);
-    addTiles('G', 2, 3);
+    addTiles('D', 4);
+    addTiles('G', 3);
 
     // 3-point letters
-    addTiles('B', 3, 2);
-    addTiles('C', 3, 2);
-    addTiles('M', 3, 2);
-    addTiles('P', 3, 2);
+    addTiles('B', 2);
+    addTiles('C', 2);
+    addTiles('M', 2);
+    addTiles('P', 2);
 
     // 4-point letters
-    addTiles('F', 4, 2);
-    addTiles('H', 4, 2);
-    addTiles('V', 4, 2);
-    addTiles('W', 4, 2);
-    addTiles('Y', 4, 2);
+    addTiles('F', 2);
+    addTiles('H', 2);
+    addTiles('V', 2);
+    addTiles('W', 2);
+    addTiles('Y', 2);
 
     // 5-point letter
-    addTiles('K', 5, 1);
+    addTiles('K', 1);
 
     // 8-point letters
-    addTiles('J', 8, 1);
-    addTiles('X', 8, 1);
+    addTiles('J', 1);
+    addTiles('X', 1);
 
     // 10-point letters
-    addTiles('Q',10, 1);
-    addTiles('Z',10, 1);
+    addTiles('Q', 1);
+    addTiles('Z', 1);
 
     // Blanks: use '?' as the letter, 0 points
-    addTiles('?', 0, 2);
+    addTiles('?', 2);
 
     return bag;
 }
 
-//Suffels the tile bag (use once at game start)
+// The bag draws at random, so "shuffling" means giving it a fresh random stream.
+// Each call mixes hardware entropy with a global counter, so games started in
+// the same second (or on different threads) never share a seed.
 void shuffleTileBag(TileBag &bag) {
-    static mt19937 rng(static_cast<unsigned int>(time(nullptr)));
-    shuffle(bag.begin(), bag.end(), rng);
+    static atomic<uint64_t> counter{0};
+    random_device rd;
+    uint64_t seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    seed ^= counter.fetch_add(0x9E3779B97F4A7C15ULL, memory_order_relaxed);
+    bag.seed(seed);
+}
+
+// --- TileBag ---
+
+void TileBag::clear() {
+    for (auto &c : counts) c = 0;
+    total = 0;
+}
+
+void TileBag::push_back(const Tile &t) {
+    add(t.letter, 1);
+}
+
+void TileBag::add(char letter, int n) {
+    int slot = TileRack::slotOf(letter);
+    if (slot < 0 || n <= 0) return;
+    counts[slot] += n;
+    total += n;
+}
+
+bool TileBag::remove(char letter) {
+    int slot = TileRack::slotOf(letter);
+    if (slot < 0 || counts[slot] == 0) return false;
+    counts[slot]--;
+    total--;
+    return true;
+}
+
+// splitmix64 step
+uint64_t TileBag::nextRandom() {
+    uint64_t z = (rngState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+Tile TileBag::draw() {
+    // Pick a tile index in [0, total) then find its slot (at most 27 steps)
+    uint32_t pick = static_cast<uint32_t>(((nextRandom() >> 32) * static_cast<uint64_t>(total)) >> 32);
+
+    int slot = 0;
+    while (pick >= counts[slot]) {
+        pick -= counts[slot];
+        slot++;
+    }
+
+    counts[slot]--;
+    total--;
+
+    Tile t;
+    t.letter = (slot == 26) ? '?' : static_cast<char>('A' + slot);
+    t.points = Scoring::letterValue(t.letter);
+    return t;
 }
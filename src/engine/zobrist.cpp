@@ -0,0 +1,35 @@
+#include "../../include/engine/zobrist.h"
+
+using namespace std;
+
+namespace Zobrist {
+
+    uint64_t rackKey(int player, const TileRack &rack) {
+        int counts[SLOT_COUNT];
+        rack.fillCounts(counts);
+        return rackKey(player, counts);
+    }
+
+    uint64_t poolKey(const TileBag &bag) {
+        int counts[SLOT_COUNT];
+        bag.fillCounts(counts);
+        return poolKey(counts);
+    }
+
+    uint64_t compute(const GameState &state) {
+        uint64_t h = 0;
+
+        for (int r = 0; r < BOARD_SIZE; r++) {
+            for (int c = 0; c < BOARD_SIZE; c++) {
+                if (state.board[r][c] != ' ') h ^= squareKey(r, c, state.board[r][c], state.blanks[r][c]);
+            }
+        }
+
+        h ^= rackKey(0, state.players[0].rack);
+        h ^= rackKey(1, state.players[1].rack);
+        h ^= poolKey(state.bag);
+
+        if (state.currentPlayerIndex == 1) h ^= KEYS.sideToMove;
+        return h;
+    }
+}
@@ -93,6 +93,7 @@ RowConstraint ConstraintGenerator::generateRowConstraint(const LetterBoard &lett
             // Already occupied
             int idx = toIdx(letters[rowIdx][col]);
             rowData.masks[col] = (idx >= 0 && idx < 26) ? (1 << idx) : 0;
+            continue;
         }
 
         // Empty Square. Check vertical constraints.
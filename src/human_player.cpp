@@ -86,7 +86,7 @@ Move HumanPlayer::getMove(const GameState& state,
         }
 
         if (choice == 'M') {
-            Move move = parseMoveInput(bonusBoard, state, state.board, state.blanks, myRack, state.bag);
+            Move move = parseMoveInput(state, state.board, state.blanks, myRack, state.bag);
             if (move.type == MoveType::PLAY) {
                 return move;
             }
@@ -145,8 +145,7 @@ Move HumanPlayer::handleRackLogic(TileRack &rack, TileBag &bag) {
     return Move(MoveType::PASS);
 }
 
-Move HumanPlayer::parseMoveInput(const Board &bonusBoard,
-                                 const GameState &state,
+Move HumanPlayer::parseMoveInput(const GameState &state,
                                  const LetterBoard &letters,
                                  const BlankBoard &blankBoard,
                                  const TileRack &rack,
@@ -190,7 +189,7 @@ Move HumanPlayer::parseMoveInput(const Board &bonusBoard,
     for(auto &c : tempMove.word) c = toupper(c);
 
     // PREVIEW via Referee (Using state from arguments)
-    MoveResult preview = Referee::validateMove(state, tempMove, bonusBoard, gDictionary);
+    MoveResult preview = Referee::validateMove(state, tempMove, gDictionary);
 
     if (!preview.success) {
         cout << "Move Failed: " << preview.message << endl;
@@ -79,22 +79,8 @@ static void printColumnHeader() {
     printHorizontalBorder();
 }
 
-static vector<string> buildTileGroups(const vector<Tile> &bag) {
-
-    // counts[0..25] = A-Z, counts[26] = '?'
-    int counts[27] = {0};
-
-    for (const Tile &tile : bag) {
-        char ch = tile.letter;
-        unsigned char uch = static_cast<unsigned char>(ch);
-
-        if (ch == '?') {
-            counts[26]++;
-        } else if (isalpha(uch)){
-            ch = static_cast<char>(toupper(uch));
-            counts[ch - 'A']++;
-        }
-    }
+// counts[0..25] = A-Z, counts[26] = '?'
+static vector<string> buildTileGroups(const int counts[27]) {
 
     // Building token gaps like "AAAAA", "BB", "??"
     vector<string> tokens;
@@ -282,15 +268,16 @@ void Renderer::printRack(const TileRack &rack) {
 }
 
 // Show the tilebag from player's prespective
-void printTileBag(const TileBag &bag, const vector<Tile> &opponentRack, bool revealOpponentRack) {
+void printTileBag(const TileBag &bag, const TileRack &opponentRack, bool revealOpponentRack) {
 
-    // Build "unseen" set of tiles (bag + opponent's rack)
-    vector<Tile> unseen;
-    unseen.reserve(bag.size() + opponentRack.size());
-    unseen.insert(unseen.end(), bag.begin(), bag.end());
-    unseen.insert(unseen.end(), opponentRack.begin(), opponentRack.end());
+    // Build "unseen" histogram of tiles (bag + opponent's rack)
+    int unseen[27];
+    int rackCounts[27];
+    bag.fillCounts(unseen);
+    opponentRack.fillCounts(rackCounts);
+    for (int i = 0; i < 27; i++) unseen[i] += rackCounts[i];
 
-    int unseenCount = static_cast<int>(unseen.size());
+    int unseenCount = static_cast<int>(bag.size() + opponentRack.size());
     int bagCount = static_cast<int>(bag.size());
     int oppCount = static_cast<int>(opponentRack.size());
 
@@ -0,0 +1,82 @@
+#include "../../include/spectre/anytime.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace spectre {
+
+// --- SearchControl ---
+
+SearchControl::SearchControl(Clock::time_point deadline, stop_token stop, ProgressCallback onProgress)
+    : start(Clock::now()), deadline(deadline), stop(std::move(stop)), onProgress(std::move(onProgress)) {}
+
+SearchControl SearchControl::withBudget(int timeLimitMs, stop_token stop, ProgressCallback onProgress) {
+    return SearchControl(Clock::now() + milliseconds(max(0, timeLimitMs)), std::move(stop), std::move(onProgress));
+}
+
+long long SearchControl::elapsedMs() const {
+    return duration_cast<milliseconds>(Clock::now() - start).count();
+}
+
+void SearchControl::report(SearchProgress progress) {
+    progress.elapsedMs = elapsedMs();
+    {
+        lock_guard<std::mutex> lock(mutex);
+        current = progress;
+    }
+    if (onProgress) onProgress(progress);
+}
+
+SearchProgress SearchControl::latest() const {
+    lock_guard<std::mutex> lock(mutex);
+    return current;
+}
+
+// --- AnytimeSearch ---
+
+AnytimeSearch::~AnytimeSearch() {
+    cancel(); // jthread joins on destruction
+}
+
+void AnytimeSearch::start(SearchFn search, int timeLimitMs, ProgressCallback onProgress) {
+    if (worker.joinable()) {
+        stopSource.request_stop();
+        worker.join();
+    }
+
+    finalMove = MoveCandidate{};
+    finalMove.word[0] = '\0';
+    stopSource = stop_source();
+    control = make_unique<SearchControl>(SearchControl::Clock::now() + milliseconds(max(0, timeLimitMs)),
+                                         stopSource.get_token(), std::move(onProgress));
+
+    worker = jthread([this, search = std::move(search)]() {
+        MoveCandidate move = search(*control);
+
+        SearchProgress done = control->latest();
+        done.best = move;
+        done.hasMove = (move.word[0] != '\0');
+        done.finished = true;
+        finalMove = move;
+        control->report(done);
+    });
+}
+
+SearchProgress AnytimeSearch::poll() const {
+    return control ? control->latest() : SearchProgress{};
+}
+
+bool AnytimeSearch::finished() const {
+    return poll().finished;
+}
+
+void AnytimeSearch::cancel() {
+    stopSource.request_stop();
+}
+
+MoveCandidate AnytimeSearch::result() {
+    if (worker.joinable()) worker.join();
+    return finalMove;
+}
+
+}
@@ -0,0 +1,124 @@
+#include "../../include/spectre/danger_map.h"
+#include "../../include/engine/scoring.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+namespace spectre {
+
+    // Does a tile on (r, c) let a word through (tr, tc) along the line?
+    static bool touchesLine(const LetterBoard& board, int r, int c, int tr, int tc, bool horizontal) {
+        // Work in line coordinates: 'along' runs with the line, 'across' beside it
+        int along = horizontal ? c - tc : r - tr;
+        int across = horizontal ? r - tr : c - tc;
+
+        // Right beside the TWS: a hook or a parallel play through it
+        if (abs(across) == 1) return abs(along) <= 1;
+        if (across != 0 || along == 0 || abs(along) > DangerMap::LINE_REACH) return false;
+
+        // On the line: open only if nothing sits in between
+        int step = (along > 0) ? 1 : -1;
+        for (int d = step; d != along; d += step) {
+            int br = horizontal ? tr : tr + d;
+            int bc = horizontal ? tc + d : tc;
+            if (board[br][bc] != ' ') return false;
+        }
+        return true;
+    }
+
+    // Best LINE_WORD-square window through the TWS, priced at average tiles
+    static int linePotential(int tr, int tc, bool horizontal) {
+        int best = 0;
+        int pos = horizontal ? tc : tr;
+        for (int start = pos - DangerMap::LINE_WORD + 1; start <= pos; start++) {
+            if (start < 0 || start + DangerMap::LINE_WORD > BOARD_SIZE) continue;
+            int letters = 0, wordMult = 1;
+            for (int i = start; i < start + DangerMap::LINE_WORD; i++) {
+                int r = horizontal ? tr : i;
+                int c = horizontal ? i : tc;
+                letters += Scoring::LETTER_MULT[r][c] * DangerMap::AVG_TILE_POINTS;
+                wordMult *= Scoring::WORD_MULT[r][c];
+            }
+            best = max(best, letters * wordMult);
+        }
+        return best;
+    }
+
+    void DangerMap::build(const LetterBoard& board) {
+        for (auto& row : masks) fill(begin(row), end(row), 0u);
+        fill(begin(lineThreat), end(lineThreat), 0);
+        alreadyOpen = 0;
+
+        int line = 0;
+        for (int tr = 0; tr < BOARD_SIZE; tr++) {
+            for (int tc = 0; tc < BOARD_SIZE; tc++) {
+                if (Scoring::WORD_MULT[tr][tc] != 3) continue;
+
+                for (int dir = 0; dir < 2 && line < MAX_LINES; dir++, line++) {
+                    // A covered TWS is spent
+                    if (board[tr][tc] != ' ') continue;
+
+                    bool horizontal = (dir == 0);
+                    uint32_t bit = 1u << line;
+                    lineThreat[line] = linePotential(tr, tc, horizontal);
+
+                    // Only squares near the TWS can touch it
+                    for (int r = max(0, tr - LINE_REACH); r <= min(BOARD_SIZE - 1, tr + LINE_REACH); r++) {
+                        for (int c = max(0, tc - LINE_REACH); c <= min(BOARD_SIZE - 1, tc + LINE_REACH); c++) {
+                            if (!touchesLine(board, r, c, tr, tc, horizontal)) continue;
+                            if (board[r][c] == ' ') masks[r][c] |= bit;
+                            else alreadyOpen |= bit;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Opening an open line again costs nothing
+        for (auto& row : masks) {
+            for (uint32_t& m : row) m &= ~alreadyOpen;
+        }
+    }
+
+    uint32_t DangerMap::maskOf(const MoveCandidate& move, const LetterBoard& board) const {
+        uint32_t mask = 0;
+        int r = move.row, c = move.col;
+        int dr = move.isHorizontal ? 0 : 1;
+        int dc = move.isHorizontal ? 1 : 0;
+        for (int i = 0; move.word[i] != '\0' && r < BOARD_SIZE && c < BOARD_SIZE; i++) {
+            if (board[r][c] == ' ') mask |= masks[r][c];
+            r += dr; c += dc;
+        }
+        return mask;
+    }
+
+    uint32_t DangerMap::maskOf(const string& word, int row, int col, bool horizontal,
+                               const LetterBoard& board) const {
+        uint32_t mask = 0;
+        int r = row, c = col;
+        int dr = horizontal ? 0 : 1;
+        int dc = horizontal ? 1 : 0;
+        // 'word' holds only the placed letters: occupied squares are stepped over
+        for (size_t i = 0; i < word.size(); i++) {
+            while (r < BOARD_SIZE && c < BOARD_SIZE && board[r][c] != ' ') {
+                r += dr; c += dc;
+            }
+            if (r < 0 || c < 0 || r >= BOARD_SIZE || c >= BOARD_SIZE) break;
+            mask |= masks[r][c];
+            r += dr; c += dc;
+        }
+        return mask;
+    }
+
+    int DangerMap::threatOf(uint32_t mask) const {
+        // The opponent gets to use one line per turn
+        int worst = 0;
+        for (int line = 0; mask != 0; line++, mask >>= 1) {
+            if (mask & 1u) worst = max(worst, lineThreat[line]);
+        }
+        return worst;
+    }
+
+}
@@ -1,9 +1,14 @@
 #include "../../include/spectre/judge.h"
+#include "../../include/spectre/win_model.h"
 #include "../../include/spectre/move_generator.h"
 #include "../../include/heuristics.h"
 #include "../../include/engine/mechanics.h"
 #include "../../include/spectre/logger.h"
+#include "../../include/spectre/transposition_table.h"
+#include "../../include/spectre/thread_pool.h"
+#include "../../include/engine/zobrist.h"
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
@@ -18,40 +23,80 @@ const int BEAM_WIDTH = 8;
 
 // --- INTERNAL HELPERS ---
 
-static Move candidateToMove(const MoveCandidate& cand) {
+// Engine moves list only the tiles being placed, starting at the first empty square
+static Move candidateToMove(const LetterBoard& board, const MoveCandidate& cand) {
     Move m;
     m.type = MoveType::PLAY;
-    m.row = cand.row;
-    m.col = cand.col;
+    m.row = -1;
+    m.col = -1;
     m.horizontal = cand.isHorizontal;
-    int i=0;
-    while(i < 15 && cand.word[i] != '\0') {
-        m.word += cand.word[i];
-        i++;
+
+    int r = cand.row;
+    int c = cand.col;
+    int dr = cand.isHorizontal ? 0 : 1;
+    int dc = cand.isHorizontal ? 1 : 0;
+
+    for (int i = 0; i < 15 && cand.word[i] != '\0'; i++) {
+        if (board[r][c] == ' ') {
+            if (m.row == -1) { m.row = r; m.col = c; }
+            m.word += cand.word[i];
+        }
+        r += dr; c += dc;
     }
+    if (m.row == -1) return Move(MoveType::PASS);
     return m;
 }
 
-static TileRack countsToRack(const int* counts) {
-    TileRack rack;
-    rack.reserve(7);
-    for(int i=0; i<26; i++) {
-        for(int k=0; k<counts[i]; k++) {
-            Tile t; t.letter = (char)('A' + i); t.points = 0;
-            rack.push_back(t);
-        }
+// Board letters + both racks (side to move first) + passes so far.
+// Values are the spread from here on, so past scores stay out of the key.
+static uint64_t positionKey(uint64_t boardKey, const int* moverCounts, const int* otherCounts, int passes) {
+    return boardKey ^ Zobrist::rackKey(0, moverCounts) ^ Zobrist::rackKey(1, otherCounts) ^
+           (static_cast<uint64_t>(passes) * Zobrist::KEYS.sideToMove);
+}
+
+// Key change of the squares a move just filled (lowercase = blank)
+static uint64_t placedKey(const LetterBoard& board, const PlyUndo& undo) {
+    uint64_t key = 0;
+    for (int i = 0; i < undo.count; i++) {
+        int r = undo.squares[i] / BOARD_SIZE;
+        int c = undo.squares[i] % BOARD_SIZE;
+        key ^= Zobrist::squareKey(r, c, board[r][c], false);
     }
-    for(int k=0; k<counts[26]; k++) {
-        Tile t; t.letter = '?'; t.points = 0;
-        rack.push_back(t);
+    return key;
+}
+
+static int tilesPlaced(const LetterBoard& board, const MoveCandidate& move) {
+    int n = 0;
+    int r = move.row, c = move.col;
+    int dr = move.isHorizontal ? 0 : 1;
+    int dc = move.isHorizontal ? 1 : 0;
+    for (int i = 0; move.word[i] != '\0' && r < BOARD_SIZE && c < BOARD_SIZE; i++) {
+        if (board[r][c] == ' ') n++;
+        r += dr; c += dc;
     }
-    return rack;
+    return n;
+}
+
+static int rackPenalty(const int* counts) {
+    int total = 0;
+    for (int i = 0; i < 26; i++) total += counts[i] * Heuristics::getTileValue((char)('A' + i));
+    return total;
 }
 
 // --- MAIN SOLVER ---
 
-Move Judge::solveEndgame(const LetterBoard& board, const Board& bonusBoard,
-                         const TileRack& myRack, const TileRack& oppRack, Dictionary& dict) {
+Move Judge::solveEndgame(const LetterBoard& board,
+                         const TileRack& myRack, const TileRack& oppRack, Dictionary& dict,
+                         int scoreDiff, int timeBudgetMs) {
+    SearchControl control = SearchControl::withBudget(timeBudgetMs);
+    MoveCandidate best = searchEndgame(board, myRack, oppRack, dict, scoreDiff, control);
+    if (best.word[0] == '\0') return Move(MoveType::PASS);
+    return candidateToMove(board, best);
+}
+
+MoveCandidate Judge::searchEndgame(const LetterBoard& board,
+                                   const TileRack& myRack, const TileRack& oppRack, Dictionary& dict,
+                                   int scoreDiff, SearchControl& control, int fixedPlies) {
 
     {
         ScopedLogger log;
@@ -74,11 +119,13 @@ Move Judge::solveEndgame(const LetterBoard& board, const Board& bonusBoard,
     // 2. Generate Root Moves
     vector<MoveCandidate> candidates = MoveGenerator::generate(board, myRack, dict, true);
 
-    if (candidates.empty()) return Move(MoveType::PASS);
+    MoveCandidate none;
+    none.word[0] = '\0';
+    if (candidates.empty()) return none;
 
     // 3. Pre-Sort by Static Score
     for(auto& c : candidates) {
-        c.score = Mechanics::calculateTrueScore(c, board, bonusBoard);
+        c.score = Mechanics::calculateTrueScore(c, board);
     }
     sort(candidates.begin(), candidates.end(), [](const MoveCandidate& a, const MoveCandidate& b) {
         return a.score > b.score;
@@ -91,143 +138,326 @@ Move Judge::solveEndgame(const LetterBoard& board, const Board& bonusBoard,
     }
 
     MoveCandidate bestMove = candidates[0];
-    int bestVal = -999999;
-    int alpha = -999999;
-    int beta = 999999;
+    int bestVal = bestMove.score;
 
-    auto startTime = steady_clock::now();
-    int timeBudgetMs = 4000;
+    // Until the first depth completes, the greedy choice is the answer
+    SearchProgress progress;
+    progress.best = bestMove;
+    progress.hasMove = true;
+    progress.value = bestMove.score;
+    control.report(progress);
 
-    // 5. Search Loop
+    // Mate in 1: going out ends the game on the spot
     for (const auto& move : candidates) {
-        LetterBoard nextBoard = board;
-        int nextMyRack[27];
-        memcpy(nextMyRack, myRackCounts, sizeof(nextMyRack));
+        if (tilesPlaced(board, move) == static_cast<int>(myRack.size())) return move;
+    }
 
-        applyMove(nextBoard, move, nextMyRack);
-        int moveScore = move.score;
+    // 5. Iterative Deepening
+    // Each depth starts from the previous depth's best move, and the table
+    // carries best moves and bounds from one depth to the next.
+    uint64_t rootKey = 0;
+    for (int r = 0; r < BOARD_SIZE; r++) {
+        for (int c = 0; c < BOARD_SIZE; c++) {
+            if (board[r][c] != ' ') rootKey ^= Zobrist::squareKey(r, c, board[r][c], false);
+        }
+    }
 
-        bool rackEmpty = true;
-        for(int i=0; i<27; i++) if(nextMyRack[i]>0) { rackEmpty=false; break; }
+    bool strictDepth = fixedPlies > 0;
+    if (strictDepth) TranspositionTable::endgame().clear();
+
+    ThreadPool& pool = ThreadPool::instance();
+    int n = static_cast<int>(candidates.size());
+
+    for (int plies = strictDepth ? fixedPlies : 1; plies <= (strictDepth ? fixedPlies : MAX_PLIES); plies++) {
+        struct RootResult {
+            int value = -999999;
+            bool horizon = false;
+            bool searched = false;
+        };
+        vector<RootResult> results(n);
+        atomic<int> bestSoFar{-999999};
+        atomic<int> next{0};
+        atomic<bool> decided{false};
+
+        // One root move on a private board and racks (make / search / unmake).
+        // 'floor' is one below the best so far, so a tie comes back exact.
+        auto searchRoot = [&](int i, int floor, LetterBoard& work, int* mine, int* theirs) {
+            const MoveCandidate& move = candidates[i];
+            PlyUndo undo;
+            applyMove(work, move, mine, undo);
+
+            bool childHorizon = false;
+            int val = move.score - minimax(work, theirs, mine, dict,
+                                           -999999, -floor, false, 0, 0, plies - 1,
+                                           rootKey ^ placedKey(work, undo), childHorizon,
+                                           strictDepth, control);
+            undoMove(work, undo, mine);
+            if (control.shouldStop()) return;
+
+            results[i] = {val, childHorizon, true};
+            int seen = bestSoFar.load(memory_order_relaxed);
+            while (val > seen && !bestSoFar.compare_exchange_weak(seen, val, memory_order_relaxed)) {}
+
+            // A won game stays won: no need to find the biggest win (only trusted
+            // when the line was searched to the end, and never in fixed-depth mode)
+            if (!strictDepth && !childHorizon &&
+                WinModel::winProbability(scoreDiff + val, 0, false) >= WinModel::DECIDED) {
+                decided.store(true, memory_order_relaxed);
+            }
+        };
+
+        // Eldest brother first (the previous best), alone, to set the bound
+        {
+            LetterBoard work = board;
+            int mine[27], theirs[27];
+            memcpy(mine, myRackCounts, sizeof(mine));
+            memcpy(theirs, oppRackCounts, sizeof(theirs));
+            searchRoot(0, -999999, work, mine, theirs);
+        }
+        next.store(1);
+
+        // Younger brothers in parallel, each against the best value when it starts
+        if (!control.shouldStop() && !decided.load() && n > 1) {
+            pool.parallelFor(min(pool.size(), n - 1), [&](int) {
+                LetterBoard work = board;
+                int mine[27], theirs[27];
+                memcpy(mine, myRackCounts, sizeof(mine));
+                memcpy(theirs, oppRackCounts, sizeof(theirs));
+
+                while (!control.shouldStop() && !decided.load(memory_order_relaxed)) {
+                    int i = next.fetch_add(1, memory_order_relaxed);
+                    if (i >= n) break;
+                    searchRoot(i, bestSoFar.load(memory_order_relaxed) - 1, work, mine, theirs);
+                }
+            });
+        }
 
-        if (rackEmpty) {
-            // Mate in 1
-            return candidateToMove(move);
+        // A depth cut short by the clock returns made-up values: drop all of it
+        if (control.shouldStop()) break;
+
+        // Highest value, ties to the earlier root move. Moves that failed low
+        // returned bounds below the final best, so they never win or tie.
+        int iterBest = -1;
+        int searched = 0;
+        bool horizon = false;
+        for (int i = 0; i < n; i++) {
+            if (!results[i].searched) continue;
+            searched++;
+            horizon = horizon || results[i].horizon;
+            if (iterBest < 0 || results[i].value > results[iterBest].value) iterBest = i;
         }
+        if (iterBest < 0) break;
 
-        int val = moveScore - minimax(nextBoard, bonusBoard, oppRackCounts, nextMyRack, dict,
-                                      -beta, -alpha, false, 0, 0, startTime, timeBudgetMs);
+        bestMove = candidates[iterBest];
+        bestVal = results[iterBest].value;
 
-        if (val > bestVal) {
-            bestVal = val;
-            bestMove = move;
+        progress.best = bestMove;
+        progress.value = bestVal;
+        progress.depth = plies;
+        progress.iterations = searched;
+        control.report(progress);
+
+        {
+            ScopedLogger log;
+            std::cout << "[JUDGE] Depth " << plies << ": " << bestMove.word << " (" << bestVal << ")"
+                      << (horizon ? "" : " solved") << std::endl;
         }
-        alpha = std::max(alpha, val);
-        if (alpha >= beta) break;
 
-        if (duration_cast<milliseconds>(steady_clock::now() - startTime).count() > timeBudgetMs) break;
+        // Nothing past the horizon: deeper searches would return the same
+        if (decided.load() || !horizon) break;
+
+        // Best move first at the next depth
+        if (iterBest > 0) {
+            rotate(candidates.begin(), candidates.begin() + iterBest, candidates.begin() + iterBest + 1);
+        }
     }
 
-    return candidateToMove(bestMove);
+    return bestMove;
 }
 
 // --- MINIMAX RECURSION ---
 
-int Judge::minimax(LetterBoard board, const Board& bonusBoard,
+int Judge::minimax(LetterBoard& board,
                    int* currentRackCounts, int* otherRackCounts,
                    Dictionary& dict,
                    int alpha, int beta,
                    bool maximizingPlayer,
                    int passesInARow,
                    int depth,
-                   const steady_clock::time_point& startTime,
-                   int timeBudgetMs) {
-
-    // Time Check
-    if ((depth & 3) == 0 && duration_cast<milliseconds>(steady_clock::now() - startTime).count() > timeBudgetMs) {
+                   int remaining,
+                   uint64_t boardKey,
+                   bool& horizon,
+                   bool strictDepth,
+                   const SearchControl& control) {
+
+    // Time / Cancel Check
+    if ((depth & 3) == 0 && control.shouldStop()) {
         return 0;
     }
 
-    TileRack rack = countsToRack(currentRackCounts);
+    // Transposition table: a deep enough entry answers or narrows the window;
+    // any entry still names the move to try first
+    TranspositionTable& table = TranspositionTable::endgame();
+    uint64_t key = positionKey(boardKey, currentRackCounts, otherRackCounts, passesInARow);
+    int alphaOrig = alpha;
+    int ttMove = TranspositionTable::NO_MOVE;
+    bool subtreeHorizon = false;
+
+    TranspositionTable::Entry entry;
+    if (table.probe(key, entry)) {
+        ttMove = entry.move;
+        bool usable = strictDepth ? (entry.depth == remaining)
+                                  : (entry.complete || entry.depth >= remaining);
+        if (usable) {
+            if (!entry.complete) subtreeHorizon = true;
+            if (entry.bound == TranspositionTable::Bound::EXACT) {
+                horizon = horizon || subtreeHorizon;
+                return entry.value;
+            }
+            if (entry.bound == TranspositionTable::Bound::LOWER) alpha = std::max(alpha, entry.value);
+            else if (entry.bound == TranspositionTable::Bound::UPPER) beta = std::min(beta, entry.value);
+            if (alpha >= beta) {
+                horizon = horizon || subtreeHorizon;
+                return entry.value;
+            }
+        }
+    }
+
+    TileRack rack = rackFromCounts(currentRackCounts);
     vector<MoveCandidate> moves = MoveGenerator::generate(board, rack, dict, false);
 
     if (moves.empty()) {
         passesInARow++;
         if (passesInARow >= 6) {
-            int myRem = 0; for(int i=0; i<26; i++) myRem += currentRackCounts[i] * Heuristics::getTileValue((char)('A'+i));
-            int oppRem = 0; for(int i=0; i<26; i++) oppRem += otherRackCounts[i] * Heuristics::getTileValue((char)('A'+i));
-            return (oppRem - myRem);
+            return rackPenalty(otherRackCounts) - rackPenalty(currentRackCounts);
         }
-        return -minimax(board, bonusBoard, otherRackCounts, currentRackCounts, dict,
-                        -beta, -alpha, !maximizingPlayer, passesInARow, depth+1, startTime, timeBudgetMs);
+        if (remaining == 0) {
+            horizon = true;
+            return 0;
+        }
+        return -minimax(board, otherRackCounts, currentRackCounts, dict,
+                        -beta, -alpha, !maximizingPlayer, passesInARow, depth+1, remaining-1,
+                        boardKey, horizon, strictDepth, control);
     }
 
-    for(auto& m : moves) m.score = calculateMoveScore(board, bonusBoard, m);
+    for(auto& m : moves) m.score = calculateMoveScore(board, m);
     sort(moves.begin(), moves.end(), [](const MoveCandidate& a, const MoveCandidate& b){ return a.score > b.score; });
 
+    int rackTiles = 0;
+    for (int i = 0; i < 27; i++) rackTiles += currentRackCounts[i];
+
+    // Horizon: the best single move (going out counted) stands in for the rest
+    if (remaining == 0) {
+        horizon = true;
+        int outBonus = 2 * rackPenalty(otherRackCounts);
+        int best = -999999;
+        for (const auto& m : moves) {
+            int v = m.score + (tilesPlaced(board, m) == rackTiles ? outBonus : 0);
+            best = std::max(best, v);
+        }
+        return best;
+    }
+
     // FORWARD PRUNING (Recursive Level)
-    // Reduce search width deeper in the tree to save time
+    // Reduce search width deeper in the tree to save time.
+    // Order: the table's move first, then the top 'limit' by score. In
+    // fixed-depth mode the table only reorders the beam, never widens it.
     int limit = (depth < 2) ? BEAM_WIDTH : (BEAM_WIDTH / 2);
-    if (moves.size() > limit) moves.resize(limit);
+    int order[BEAM_WIDTH + 1];
+    int orderCount = 0;
+    int widest = strictDepth ? min(limit, static_cast<int>(moves.size())) : static_cast<int>(moves.size());
+    if (ttMove != TranspositionTable::NO_MOVE && ttMove < widest) order[orderCount++] = ttMove;
+    for (int i = 0; i < static_cast<int>(moves.size()) && i < limit; i++) {
+        if (i != ttMove) order[orderCount++] = i;
+    }
 
     int bestVal = -999999;
+    int bestIndex = TranspositionTable::NO_MOVE;
 
-    for (const auto& move : moves) {
-        LetterBoard nextBoard = board;
-        int nextRack[27];
-        memcpy(nextRack, currentRackCounts, sizeof(nextRack));
-
-        applyMove(nextBoard, move, nextRack);
+    for (int k = 0; k < orderCount; k++) {
+        const MoveCandidate& move = moves[order[k]];
+        PlyUndo undo;
+        applyMove(board, move, currentRackCounts, undo);
         int moveScore = move.score;
 
         bool rackEmpty = true;
-        for(int i=0; i<27; i++) if(nextRack[i]>0) { rackEmpty=false; break; }
+        for(int i=0; i<27; i++) if(currentRackCounts[i]>0) { rackEmpty=false; break; }
 
+        int val;
         if (rackEmpty) {
-            int bonus = 0;
-            for(int i=0; i<26; i++) bonus += otherRackCounts[i] * Heuristics::getTileValue((char)('A'+i));
-            int total = moveScore + (2 * bonus);
-            if (total > bestVal) bestVal = total;
-            alpha = std::max(alpha, bestVal);
-            if (alpha >= beta) break;
-            continue;
+            undoMove(board, undo, currentRackCounts);
+            val = moveScore + 2 * rackPenalty(otherRackCounts);
+        } else {
+            val = moveScore - minimax(board, otherRackCounts, currentRackCounts, dict,
+                                      -beta, -alpha, !maximizingPlayer, 0, depth+1, remaining-1,
+                                      boardKey ^ placedKey(board, undo), subtreeHorizon, strictDepth, control);
+            undoMove(board, undo, currentRackCounts);
         }
 
-        int val = moveScore - minimax(nextBoard, bonusBoard, otherRackCounts, nextRack, dict,
-                                      -beta, -alpha, !maximizingPlayer, 0, depth+1, startTime, timeBudgetMs);
-
-        if (val > bestVal) bestVal = val;
+        if (val > bestVal) {
+            bestVal = val;
+            bestIndex = order[k];
+        }
         alpha = std::max(alpha, bestVal);
         if (alpha >= beta) break;
     }
 
+    // Values from an interrupted search are not worth keeping
+    if (!control.shouldStop()) {
+        TranspositionTable::Entry result;
+        result.value = bestVal;
+        result.depth = remaining;
+        result.move = std::min(bestIndex, static_cast<int>(TranspositionTable::NO_MOVE));
+        result.complete = !subtreeHorizon;
+        result.bound = (bestVal <= alphaOrig) ? TranspositionTable::Bound::UPPER
+                     : (bestVal >= beta) ? TranspositionTable::Bound::LOWER
+                     : TranspositionTable::Bound::EXACT;
+        table.store(key, result);
+    }
+
+    horizon = horizon || subtreeHorizon;
     return bestVal;
 }
 
-int Judge::calculateMoveScore(const LetterBoard& board, const Board& bonusBoard, const MoveCandidate& move) {
-    return Mechanics::calculateTrueScore(move, board, bonusBoard);
+int Judge::calculateMoveScore(const LetterBoard& board, const MoveCandidate& move) {
+    return Mechanics::calculateTrueScore(move, board);
 }
 
-void Judge::applyMove(LetterBoard& board, const MoveCandidate& move, int* rackCounts) {
+void Judge::applyMove(LetterBoard& board, const MoveCandidate& move, int* rackCounts, PlyUndo& undo) {
     int r = move.row;
     int c = move.col;
     int dr = move.isHorizontal ? 0 : 1;
     int dc = move.isHorizontal ? 1 : 0;
 
+    undo.count = 0;
+
     for (int i=0; move.word[i] != '\0'; i++) {
         if (board[r][c] == ' ') {
-            board[r][c] = move.word[i];
             char letter = move.word[i];
+            int slot = 0xFF;
             if (letter >= 'a' && letter <= 'z') {
-                if (rackCounts[26] > 0) rackCounts[26]--;
+                if (rackCounts[26] > 0) slot = 26;
             } else {
                 int idx = letter - 'A';
-                if (rackCounts[idx] > 0) rackCounts[idx]--;
-                else if (rackCounts[26] > 0) rackCounts[26]--;
+                if (rackCounts[idx] > 0) slot = idx;
+                else if (rackCounts[26] > 0) { slot = 26; letter = (char)tolower(letter); }
             }
+            if (slot != 0xFF) rackCounts[slot]--;
+
+            board[r][c] = letter;
+            undo.squares[undo.count] = (uint8_t)(r * BOARD_SIZE + c);
+            undo.rackSlots[undo.count] = (uint8_t)slot;
+            undo.count++;
         }
         r += dr; c += dc;
     }
 }
 
+void Judge::undoMove(LetterBoard& board, const PlyUndo& undo, int* rackCounts) {
+    for (int i = undo.count - 1; i >= 0; i--) {
+        board[undo.squares[i] / BOARD_SIZE][undo.squares[i] % BOARD_SIZE] = ' ';
+        if (undo.rackSlots[i] != 0xFF) rackCounts[undo.rackSlots[i]]++;
+    }
+}
+
 }
\ No newline at end of file
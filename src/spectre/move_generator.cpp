@@ -23,11 +23,7 @@ vector<MoveCandidate> MoveGenerator::generate(const LetterBoard &board, const Ti
         // Calculate Leave (Speedi_Pi needs this!)
         int leaveIdx = 0;
         for(int i=0; i<26; i++) {
-            int count = rackCounts[i];
-            if (count > 0) {
-                cand.leave[leaveIdx++] = (char)('A' + i);
-                if (count > 1) cand.leave[leaveIdx++] = (char)('A' + i);
-            }
+            for(int k=0; k<rackCounts[i]; k++) cand.leave[leaveIdx++] = (char)('A' + i);
         }
         for(int k=0; k<rackCounts[26]; k++) cand.leave[leaveIdx++] = '?';
         cand.leave[leaveIdx] = '\0';
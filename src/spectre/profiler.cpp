@@ -1,50 +1,22 @@
 #include "../../include/spectre/profiler.h"
+#include "../../include/spectre/danger_map.h"
 #include <iostream>
 
 using namespace std;
 
 namespace spectre {
 
-    // Helper: Is this cell a Triple Word Score?
-    bool isTWS(int r, int c) {
-        if (r == 0 || r == 7 || r == 14) {
-            if (c == 0 || c == 7 || c == 14) return true;
-        }
-        return false;
-    }
-
     void Profiler::observe(const Move& actualMove, const LetterBoard& board) {
         if (data.turnsAnalyzed >= ANALYSIS_WINDOW) return;
 
         // DETECT GREEDY BEHAVIOR:
-        // Greedy bots often place tiles NEXT to a Triple Word Score (TWS)
-        // without covering it, just to get a few extra points.
-
-        bool leftTWSOpen = false;
-
-        int r = actualMove.row;
-        int c = actualMove.col;
-        int dr = actualMove.horizontal ? 0 : 1;
-        int dc = actualMove.horizontal ? 1 : 0;
-
-        for(int i=0; i<actualMove.word.length(); i++) {
-            // Check 4 neighbors
-            int nr[] = {r+1, r-1, r, r};
-            int nc[] = {c, c, c+1, c-1};
-
-            for(int k=0; k<4; k++) {
-                int checkR = nr[k];
-                int checkC = nc[k];
-
-                if (checkR >= 0 && checkR < 15 && checkC >= 0 && checkC < 15) {
-                    // If neighbor is TWS and it is EMPTY
-                    if (isTWS(checkR, checkC) && board[checkR][checkC] == ' ') {
-                        leftTWSOpen = true;
-                    }
-                }
-            }
-            r += dr; c += dc;
-        }
+        // Greedy bots often open a Triple Word Score lane for a few extra
+        // points. The danger map of the board they moved on says which
+        // squares open a lane the board did not already have.
+        DangerMap danger;
+        danger.build(board);
+        bool leftTWSOpen = danger.maskOf(actualMove.word, actualMove.row, actualMove.col,
+                                         actualMove.horizontal, board) != 0;
 
         data.turnsAnalyzed++;
         if (leftTWSOpen) {
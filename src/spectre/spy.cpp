@@ -1,79 +1,109 @@
 #include "../../include/spectre/spy.h"
-#include "../../include/tile_tracker.h"
 #include "../../include/spectre/move_generator.h"
 #include "../../include/engine/mechanics.h"
 #include "../../include/engine/dictionary.h"
 #include "../../include/spectre/logger.h"
+#include "../../include/spectre/treasurer.h"
+#include "../../include/spectre/thread_pool.h"
+#include "../../include/spectre/anytime.h"
+#include "../../include/engine/scoring.h"
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <cmath>
 #include <map>
 #include <random>
+#include <unordered_map>
 
 using namespace std;
 
 namespace spectre {
 
 Spy::Spy() {
-    particles.resize(PARTICLE_COUNT);
-    for(auto& p : particles) p.weight = 1.0;
+    rackCounts.assign(static_cast<size_t>(PARTICLE_COUNT) * SLOTS, 0);
+    rackSizes.assign(PARTICLE_COUNT, 0);
+    weights.assign(PARTICLE_COUNT, 1.0);
+    spareCounts.assign(rackCounts.size(), 0);
+    spareSizes.assign(PARTICLE_COUNT, 0);
 }
 
-// Helper to generate a cache key from a rack
-std::string getRackKey(const std::vector<char>& rack) {
-    std::string s(rack.begin(), rack.end());
-    std::sort(s.begin(), s.end());
+// One generator per thread for every draw the Spy makes (seeded once, no locking)
+static std::mt19937_64& spyRng() {
+    static thread_local std::mt19937_64 rng(std::random_device{}());
+    return rng;
+}
+
+// Uniform integer in [0, n) from one 64-bit draw (multiply-shift, no division)
+static int uniformBelow(std::mt19937_64& rng, int n) {
+    return static_cast<int>(((rng() >> 32) * static_cast<uint64_t>(n)) >> 32);
+}
+
+// Helper to generate a cache key from a rack (histogram order is sorted order)
+static std::string getRackKey(const uint8_t* counts) {
+    std::string s;
+    for (int slot = 0; slot < 27; slot++) {
+        s.append(counts[slot], slot == 26 ? '?' : static_cast<char>('A' + slot));
+    }
     return s;
 }
 
 void Spy::observeOpponentMove(const Move& move, const LetterBoard& preMoveBoard, OpponentType oppType) {
-    if (unseenPool.empty()) return;
+    if (unseenTotal == 0) return;
 
     // 1. DEDUCE PLAYED TILES (Positive Inference)
-    std::vector<char> tilesPlayed;
+    // Letters as a histogram; lowercase letters were played with a blank
+    int played[27] = {0};
     int r = move.row; int c = move.col;
     int dr = move.horizontal ? 0 : 1;
     int dc = move.horizontal ? 1 : 0;
 
+    // move.word is the placed letters only: step over tiles already down
     for (char letter : move.word) {
-        if (preMoveBoard[r][c] == ' ') {
-            tilesPlayed.push_back(letter);
+        while (r < BOARD_SIZE && c < BOARD_SIZE && preMoveBoard[r][c] != ' ') {
+            r += dr; c += dc;
         }
+        if (r >= BOARD_SIZE || c >= BOARD_SIZE) break;
+        int slot = (letter >= 'a' && letter <= 'z') ? 26 : TileRack::slotOf(letter);
+        if (slot >= 0) played[slot]++;
         r += dr; c += dc;
     }
 
+    // Slots actually played (at most 7), so the per-particle loops skip the rest
+    int playedSlots[27];
+    int playedKinds = 0;
+    for (int slot = 0; slot < 27; slot++) {
+        if (played[slot] > 0) playedSlots[playedKinds++] = slot;
+    }
+
     // 2. PARTICLE UPDATE LOOP
     double totalWeight = 0.0;
 
-    for (auto& p : particles) {
+    for (int i = 0; i < PARTICLE_COUNT; i++) {
         // A. HARD FILTER (Consistency Check)
-        std::vector<char> rackCopy = p.rack;
-        bool possible = true;
-        for (char t : tilesPlayed) {
-            auto it = std::find(rackCopy.begin(), rackCopy.end(), t);
-            if (it != rackCopy.end()) *it = ' ';
-            else {
-                auto bit = std::find(rackCopy.begin(), rackCopy.end(), '?');
-                if (bit != rackCopy.end()) *bit = ' ';
-                else { possible = false; break; }
-            }
+        // Letters the rack lacks must come from its blanks
+        const uint8_t* rack = rackOf(i);
+        int blanksNeeded = 0;
+        for (int k = 0; k < playedKinds; k++) {
+            int slot = playedSlots[k];
+            if (slot == 26) blanksNeeded += played[slot];
+            else if (played[slot] > rack[slot]) blanksNeeded += played[slot] - rack[slot];
         }
 
-        if (!possible) {
-            p.weight = 0.0;
+        if (blanksNeeded > rack[26]) {
+            weights[i] = 0.0;
             continue;
         }
 
-        // B. SOFT FILTER (Negative Inference)
-        // [CRITICAL FIX] Only apply if opponent is explicitly SMART.
-        // If they are Greedy (Speedi_Pi) or Unknown, we skip this to prevent hallucinations.
-        if (oppType == OpponentType::SMART) {
-             // Placeholder for advanced inference.
-             // For now, keeping it neutral ensures stability against aggressive bots.
-             p.weight *= 1.0;
-        }
+        totalWeight += weights[i];
+    }
 
-        totalWeight += p.weight;
+    // B. SOFT FILTER (Negative Inference)
+    // [CRITICAL FIX] Only apply if opponent is explicitly SMART.
+    // If they are Greedy (Speedi_Pi) or Unknown, we skip this to prevent hallucinations.
+    if (oppType == OpponentType::SMART && totalWeight > 0.0) {
+        weighByPlay(move, preMoveBoard, played);
+        totalWeight = 0.0;
+        for (int i = 0; i < PARTICLE_COUNT; i++) totalWeight += weights[i];
     }
 
     // 3. RESAMPLE
@@ -83,143 +113,335 @@ void Spy::observeOpponentMove(const Move& move, const LetterBoard& preMoveBoard,
         resampleParticles(totalWeight);
     }
 
-    // 4. TRANSITION (Remove played tiles)
-    for(auto& p : particles) {
-        for(char t : tilesPlayed) {
-            auto it = std::find(p.rack.begin(), p.rack.end(), t);
-            if(it != p.rack.end()) p.rack.erase(it);
-            else {
-                auto bit = std::find(p.rack.begin(), p.rack.end(), '?');
-                if(bit != p.rack.end()) p.rack.erase(bit);
-            }
+    // 4. TRANSITION (Remove played tiles, blanks covering what the rack lacks)
+    for (int i = 0; i < PARTICLE_COUNT; i++) {
+        uint8_t* rack = rackOf(i);
+        int removed = 0;
+        for (int k = 0; k < playedKinds; k++) {
+            int slot = playedSlots[k];
+            int own = std::min<int>(played[slot], rack[slot]);
+            int fromBlank = std::min<int>(played[slot] - own, rack[26]);
+            rack[slot] = static_cast<uint8_t>(rack[slot] - own);
+            rack[26] = static_cast<uint8_t>(rack[26] - fromBlank);
+            removed += own + fromBlank;
         }
+        rackSizes[i] = static_cast<uint8_t>(rackSizes[i] - removed);
     }
 }
 
-int Spy::findBestPossibleScore(const std::vector<char>& rack, const LetterBoard& board) {
-    TileRack tRack;
-    for(char c : rack) {
-        Tile t; t.letter = c; t.points = 0;
-        tRack.push_back(t);
-    }
+void Spy::weighByPlay(const Move& move, const LetterBoard& board, const int* played) {
+    // 1. Distinct racks among the live particles, most common first
+    std::unordered_map<std::string, int> classOf;
+    std::vector<int> firstParticle;
+    std::vector<int> members;
+    std::vector<int> particleClass(PARTICLE_COUNT, -1);
 
-    vector<MoveCandidate> moves = MoveGenerator::generate(board, tRack, gDictionary, false);
-    if (moves.empty()) return 0;
+    for (int i = 0; i < PARTICLE_COUNT; i++) {
+        if (weights[i] <= 0.0) continue;
+        auto it = classOf.emplace(getRackKey(rackOf(i)), static_cast<int>(firstParticle.size())).first;
+        if (it->second == static_cast<int>(firstParticle.size())) {
+            firstParticle.push_back(i);
+            members.push_back(0);
+        }
+        particleClass[i] = it->second;
+        members[it->second]++;
+    }
 
-    int maxScore = 0;
-    Board bonusBoard = createBoard();
+    int classes = static_cast<int>(firstParticle.size());
+    std::vector<int> order(classes);
+    for (int k = 0; k < classes; k++) order[k] = k;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return members[a] > members[b]; });
+    int toScore = std::min(classes, INFERENCE_RACKS);
 
-    for (const auto& m : moves) {
-        int s = Mechanics::calculateTrueScore(m, board, bonusBoard);
-        if (s > maxScore) maxScore = s;
+    // 2. The play's own tiles (one word letter per empty square, blanks lowercase)
+    Scoring::Placement placement;
+    placement.horizontal = move.horizontal;
+    int r = move.row, c = move.col;
+    int dr = move.horizontal ? 0 : 1;
+    int dc = move.horizontal ? 1 : 0;
+    for (char letter : move.word) {
+        while (r < BOARD_SIZE && c < BOARD_SIZE && board[r][c] != ' ') {
+            r += dr; c += dc;
+        }
+        if (r >= BOARD_SIZE || c >= BOARD_SIZE) break;
+        bool isBlank = (letter >= 'a' && letter <= 'z');
+        placement.add(r, c, static_cast<char>(toupper(static_cast<unsigned char>(letter))), isBlank);
+        r += dr; c += dc;
     }
-    return maxScore;
-}
+    int actualScore = Scoring::scorePlacement(board, nullptr, placement);
+
+    // 3. Equity lost by the play, per rack, in parallel on shared constraints
+    BoardConstraints constraints;
+    constraints.build(board);
+    SearchControl control = SearchControl::withBudget(INFERENCE_BUDGET_MS);
+
+    std::vector<double> likelihood(classes, 0.0);
+    std::vector<char> scored(classes, 0);
+    std::atomic<int> next{0};
+
+    ThreadPool& pool = ThreadPool::instance();
+    pool.parallelFor(std::min(pool.size(), std::max(toScore, 1)), [&](int) {
+        int rackCounts[27];
+        while (!control.shouldStop()) {
+            int n = next.fetch_add(1, std::memory_order_relaxed);
+            if (n >= toScore) break;
+            int cls = order[n];
+            const uint8_t* rack = rackOf(firstParticle[cls]);
+
+            // The play's own leave (blanks cover letters the rack lacks)
+            int leave[27];
+            for (int slot = 0; slot < 27; slot++) leave[slot] = rack[slot];
+            for (int slot = 0; slot < 27; slot++) {
+                int own = std::min(played[slot], leave[slot]);
+                leave[slot] -= own;
+                leave[26] -= std::min(played[slot] - own, leave[26]);
+            }
+            double actualEquity = actualScore + Treasurer::leaveValue(leave);
+
+            double bestEquity = actualEquity;
+            auto best = [&](MoveCandidate& cand, int* remaining) -> bool {
+                double equity = Mechanics::calculateTrueScore(cand, board) + Treasurer::leaveValue(remaining);
+                if (equity > bestEquity) bestEquity = equity;
+                return true;
+            };
+            for (int slot = 0; slot < 27; slot++) rackCounts[slot] = rack[slot];
+            MoveGenerator::generate_prepared(board, constraints, rackCounts, gDictionary, best);
+
+            likelihood[cls] = std::max(INFERENCE_FLOOR, std::exp(-(bestEquity - actualEquity) / INFERENCE_TEMPERATURE));
+            scored[cls] = 1;
+        }
+    });
 
-    void Spy::updateGroundTruth(const LetterBoard& board, const TileRack& myRack, const TileBag& bag) {
-    // 1. Rebuild Unseen Pool
-    unseenPool.clear();
-    TileTracker tracker;
-    for(int r=0; r<15; r++) for(int c=0; c<15; c++)
-        if(board[r][c] != ' ') tracker.markSeen(board[r][c]);
-    for(const auto& t : myRack) tracker.markSeen(t.letter);
+    // 4. Racks left unscored stay neutral: the mean likelihood of the scored ones
+    double sum = 0.0;
+    int count = 0, racksScored = 0;
+    for (int k = 0; k < classes; k++) {
+        if (scored[k]) { sum += likelihood[k] * members[k]; count += members[k]; racksScored++; }
+    }
+    if (count == 0) return;
+    double neutral = sum / count;
 
-    string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ?";
-    for (char c : alphabet) {
-        int count = tracker.getUnseenCount(c);
-        for (int k=0; k<count; k++) unseenPool.push_back(c);
+    for (int i = 0; i < PARTICLE_COUNT; i++) {
+        if (particleClass[i] < 0) continue;
+        int cls = particleClass[i];
+        weights[i] *= scored[cls] ? likelihood[cls] : neutral;
     }
 
+    ScopedLogger log;
+    std::cout << "[SPY] Inference: " << racksScored << "/" << classes << " racks scored, mean likelihood "
+              << neutral << std::endl;
+}
+
+void Spy::updateGroundTruth(const UnseenView& unseen) {
+    // 1. Sync Unseen Pool (kept up to date by the engine, no board scan)
+    unseen.fillCounts(unseenCounts);
+    unseenTotal = unseen.total;
+
     {
         ScopedLogger log;
-        std::cout << "[SPY] Ground Truth: " << unseenPool.size() << " tiles unseen." << std::endl;
+        std::cout << "[SPY] Ground Truth: " << unseenTotal << " tiles unseen." << std::endl;
     }
 
+    enumerateRacks();
+
     // 2. REFILL PARTICLES
-    static thread_local std::mt19937 rng(std::random_device{}());
-
-    if(particles.empty()) { initParticles(); return; }
-
-    for (auto& p : particles) {
-        // Sanity check size
-        if (p.rack.size() > 7) p.rack.resize(7);
-
-        // CREATE A LOCAL COPY of available tiles for this specific particle refill
-        // This is expensive but necessary for correctness.
-        // Optimization: Only copy if we actually need to draw.
-        if (p.rack.size() < 7 && !unseenPool.empty()) {
-            std::vector<char> localPool = unseenPool;
-            // Remove tiles that are ALREADY in this particle's rack
-            // (Because unseenPool includes the opponent's current tiles)
-            for(char existing : p.rack) {
-                auto it = std::find(localPool.begin(), localPool.end(), existing);
-                if(it != localPool.end()) localPool.erase(it);
-            }
+    refillParticles();
+}
+
+void Spy::refillParticles() {
+    // Letters that left the pool since the last refill (our draws, their plays)
+    int shrunk[SLOTS];
+    int shrunkCount = 0;
+    for (int slot = 0; slot < SLOTS; slot++) {
+        if (unseenCounts[slot] < refilledFrom[slot]) shrunk[shrunkCount++] = slot;
+        refilledFrom[slot] = unseenCounts[slot];
+    }
 
-            // Now draw from the remaining valid pool
-            std::shuffle(localPool.begin(), localPool.end(), rng);
+    if (unseenTotal == 0) {
+        std::fill(rackCounts.begin(), rackCounts.end(), 0);
+        std::fill(rackSizes.begin(), rackSizes.end(), 0);
+        return;
+    }
+    std::mt19937_64& rng = spyRng();
+
+    // The unseen pool laid out flat: entry j is copy tileCopy[j] of slot tileSlot[j]
+    int flat = 0;
+    for (int slot = 0; slot < SLOTS; slot++) {
+        for (int k = 0; k < unseenCounts[slot] && flat < MAX_UNSEEN; k++, flat++) {
+            tileSlot[flat] = static_cast<uint8_t>(slot);
+            tileCopy[flat] = static_cast<uint8_t>(k);
+        }
+    }
 
-            // [FIX] Robust Refill Loop
-            // Ensure we don't draw if pool is empty OR rack is full
-            while(p.rack.size() < 7 && !localPool.empty()) {
-                p.rack.push_back(localPool.back());
-                localPool.pop_back();
+    int target = std::min(flat, 7);
+    for (int i = 0; i < PARTICLE_COUNT; i++) {
+        uint8_t* rack = rackOf(i);
+
+        // Racks may still hold those tiles: drop what the pool no longer has
+        for (int k = 0; k < shrunkCount; k++) {
+            int slot = shrunk[k];
+            if (rack[slot] > unseenCounts[slot]) {
+                rackSizes[i] = static_cast<uint8_t>(rackSizes[i] - (rack[slot] - unseenCounts[slot]));
+                rack[slot] = static_cast<uint8_t>(unseenCounts[slot]);
             }
+        }
 
-            // Sanity Clip
-            // If for some reason we have >7 (should be impossible, but safety first)
-            if (p.rack.size() > 7) p.rack.resize(7);
+        // A rack holding n of a letter owns copies 0..n-1, so a uniform pick of
+        // the flat pool is free exactly when its copy number is >= n. While most
+        // of the pool is free, rejection costs O(1) per tile.
+        while (rackSizes[i] < target) {
+            int free = flat - rackSizes[i];
+            int slot;
+            if (2 * free >= flat) {
+                int j;
+                do { j = uniformBelow(rng, flat); } while (tileCopy[j] < rack[tileSlot[j]]);
+                slot = tileSlot[j];
+            } else {
+                // Small pool: walk the free counts instead
+                int pick = uniformBelow(rng, free);
+                slot = 0;
+                while (pick >= unseenCounts[slot] - rack[slot]) {
+                    pick -= unseenCounts[slot] - rack[slot];
+                    slot++;
+                }
+            }
+            rack[slot]++;
+            rackSizes[i]++;
         }
     }
 }
 
 void Spy::initParticles() {
-    static thread_local std::mt19937 rng(std::random_device{}());
-    for(int i=0; i<PARTICLE_COUNT; i++) {
-        particles[i].rack.clear();
-        particles[i].weight = 1.0;
+    std::fill(rackCounts.begin(), rackCounts.end(), 0);
+    std::fill(rackSizes.begin(), rackSizes.end(), 0);
+    std::fill(weights.begin(), weights.end(), 1.0);
+    refillParticles();
+}
+
+void Spy::resampleParticles(double totalWeight) {
+    std::mt19937_64& rng = spyRng();
 
-        // Safety: If pool is empty, we can't fill.
-        if (unseenPool.empty()) continue;
+    // N pointers spaced totalWeight / N apart from one random offset: O(N),
+    // and every particle with weight w is copied floor or ceil of w * N / total times
+    double step = totalWeight / PARTICLE_COUNT;
+    double pointer = std::uniform_real_distribution<double>(0.0, step)(rng);
+    double cumulative = weights[0];
+    int src = 0;
 
-        std::vector<char> pool = unseenPool;
-        std::shuffle(pool.begin(), pool.end(), rng);
+    for (int i = 0; i < PARTICLE_COUNT; i++) {
+        while (cumulative < pointer && src < PARTICLE_COUNT - 1) cumulative += weights[++src];
 
-        int draw = std::min((int)pool.size(), 7);
-        for(int k=0; k<draw; k++) particles[i].rack.push_back(pool[k]);
+        std::copy(rackOf(src), rackOf(src) + SLOTS, &spareCounts[static_cast<size_t>(i) * SLOTS]);
+        spareSizes[i] = rackSizes[src];
+        pointer += step;
     }
+
+    rackCounts.swap(spareCounts);
+    rackSizes.swap(spareSizes);
+
+    // Normalize weights after resampling
+    std::fill(weights.begin(), weights.end(), 1.0);
 }
 
-void Spy::resampleParticles(double totalWeight) {
-    std::vector<Particle> newParticles;
-    newParticles.reserve(PARTICLE_COUNT);
+// C(n, k) for n <= 16 (tiles of one letter in the pool)
+static double choose(int n, int k) {
+    if (k < 0 || k > n) return 0.0;
+    double r = 1.0;
+    for (int i = 1; i <= k; i++) r = r * (n - k + i) / i;
+    return r;
+}
 
-    static thread_local std::mt19937 rng(std::random_device{}());
-    std::uniform_real_distribution<double> dist(0.0, totalWeight);
+void Spy::enumerateRacks() {
+    exactRacks.clear();
+    exactCumulative.clear();
+    if (unseenTotal == 0 || unseenTotal > EXACT_POOL_MAX) return;
+
+    // Depth-first over the slots: k_s tiles of slot s, weight = prod C(n_s, k_s)
+    int rackSize = std::min(unseenTotal, 7);
+    RackWeight current{};
+    current.size = static_cast<uint8_t>(rackSize);
+    bool overflow = false;
+
+    auto visit = [&](auto&& self, int slot, int left, double weight) -> void {
+        if (overflow) return;
+        if (left == 0) {
+            if (static_cast<int>(exactRacks.size()) == EXACT_RACK_LIMIT) { overflow = true; return; }
+            current.weight = weight;
+            exactRacks.push_back(current);
+            return;
+        }
+        if (slot == SLOTS) return;
 
-    for (int i = 0; i < PARTICLE_COUNT; i++) {
-        double r = dist(rng);
-        double currentSum = 0.0;
-
-        for (const auto& p : particles) {
-            currentSum += p.weight;
-            if (currentSum >= r) {
-                newParticles.push_back(p);
-                break;
-            }
+        int most = std::min(left, unseenCounts[slot]);
+        for (int k = most; k >= 0; k--) {
+            current.counts[slot] = static_cast<uint8_t>(k);
+            self(self, slot + 1, left - k, weight * choose(unseenCounts[slot], k));
         }
+        current.counts[slot] = 0;
+    };
+    visit(visit, 0, rackSize, 1.0);
+
+    if (overflow) {
+        exactRacks.clear();
+        return;
     }
 
-    // Normalize weights after resampling
-    for(auto& p : newParticles) p.weight = 1.0;
-    particles = newParticles;
+    // Normalise by C(N, k), the number of equally likely tile draws
+    double total = choose(unseenTotal, rackSize);
+    double running = 0.0;
+    exactCumulative.reserve(exactRacks.size());
+    for (auto& rack : exactRacks) {
+        rack.weight /= total;
+        running += rack.weight;
+        exactCumulative.push_back(running);
+    }
+
+    ScopedLogger log;
+    std::cout << "[SPY] Exact mode: " << exactRacks.size() << " possible racks." << std::endl;
+}
+
+int Spy::sampleRack(int* counts) const {
+    std::mt19937_64& rng = spyRng();
+
+    if (!exactRacks.empty()) {
+        double u = std::uniform_real_distribution<double>(0.0, exactCumulative.back())(rng);
+        size_t k = std::upper_bound(exactCumulative.begin(), exactCumulative.end(), u) - exactCumulative.begin();
+        const RackWeight& rack = exactRacks[std::min(k, exactRacks.size() - 1)];
+        for (int slot = 0; slot < SLOTS; slot++) counts[slot] = rack.counts[slot];
+        return rack.size;
+    }
+
+    int i = uniformBelow(rng, PARTICLE_COUNT);
+
+    const uint8_t* rack = rackOf(i);
+    for (int slot = 0; slot < SLOTS; slot++) counts[slot] = rack[slot];
+    return rackSizes[i];
 }
 
 std::vector<char> Spy::generateWeightedRack() const {
-    if (particles.empty()) return {};
-    static thread_local std::mt19937 rng(std::random_device{}());
-    std::uniform_int_distribution<int> dist(0, particles.size() - 1);
-    return particles[dist(rng)].rack;
+    int counts[27];
+    sampleRack(counts);
+
+    std::vector<char> rack;
+    for (int slot = 0; slot < SLOTS; slot++) {
+        for (int k = 0; k < counts[slot]; k++) rack.push_back(slot == 26 ? '?' : static_cast<char>('A' + slot));
+    }
+    return rack;
 }
 
-}
\ No newline at end of file
+std::vector<char> Spy::likeliestRack() const {
+    if (exactRacks.empty()) return generateWeightedRack();
+
+    const RackWeight* best = &exactRacks[0];
+    for (const auto& rack : exactRacks) {
+        if (rack.weight > best->weight) best = &rack;
+    }
+
+    std::vector<char> rack;
+    for (int slot = 0; slot < SLOTS; slot++) {
+        for (int k = 0; k < best->counts[slot]; k++) rack.push_back(slot == 26 ? '?' : static_cast<char>('A' + slot));
+    }
+    return rack;
+}
+
+}
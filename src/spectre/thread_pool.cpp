@@ -0,0 +1,74 @@
+#include "../../include/spectre/thread_pool.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace spectre {
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount < 1) threadCount = 1;
+    workers.reserve(threadCount);
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool(static_cast<int>(std::max(1u, thread::hardware_concurrency())));
+    return pool;
+}
+
+void ThreadPool::submit(function<void()> task) {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+}
+
+void ThreadPool::parallelFor(int jobs, const function<void(int)>& job) {
+    if (jobs <= 0) return;
+
+    // Completion counter for the helper jobs (job 0 runs on this thread)
+    std::mutex doneMutex;
+    condition_variable doneCv;
+    int remaining = jobs - 1;
+
+    for (int i = 1; i < jobs; i++) {
+        submit([&, i]() {
+            job(i);
+            lock_guard<std::mutex> lock(doneMutex);
+            if (--remaining == 0) doneCv.notify_one();
+        });
+    }
+
+    job(0);
+
+    unique_lock<std::mutex> lock(doneMutex);
+    doneCv.wait(lock, [&]() { return remaining == 0; });
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+}
@@ -0,0 +1,58 @@
+#include "../../include/spectre/transposition_table.h"
+
+using namespace std;
+
+namespace spectre {
+
+    // Data word: value (16 bits, signed) | depth (8) | bound (2) | complete (1) | move (16)
+    static uint64_t pack(const TranspositionTable::Entry& e) {
+        return static_cast<uint64_t>(static_cast<uint16_t>(static_cast<int16_t>(e.value))) |
+               (static_cast<uint64_t>(static_cast<uint8_t>(e.depth)) << 16) |
+               (static_cast<uint64_t>(e.bound) << 24) |
+               (static_cast<uint64_t>(e.complete ? 1 : 0) << 26) |
+               (static_cast<uint64_t>(static_cast<uint16_t>(e.move)) << 32);
+    }
+
+    static TranspositionTable::Entry unpack(uint64_t data) {
+        TranspositionTable::Entry e;
+        e.value = static_cast<int16_t>(data & 0xFFFF);
+        e.depth = static_cast<int>((data >> 16) & 0xFF);
+        e.bound = static_cast<TranspositionTable::Bound>((data >> 24) & 0x3);
+        e.complete = ((data >> 26) & 0x1) != 0;
+        e.move = static_cast<int>((data >> 32) & 0xFFFF);
+        return e;
+    }
+
+    TranspositionTable::TranspositionTable(int sizeLog2)
+        : slots(new Slot[size_t(1) << sizeLog2]), mask((uint64_t(1) << sizeLog2) - 1) {}
+
+    bool TranspositionTable::probe(uint64_t key, Entry& out) const {
+        const Slot& slot = slots[key & mask];
+        uint64_t data = slot.data.load(memory_order_relaxed);
+        uint64_t check = slot.check.load(memory_order_relaxed);
+        if ((check ^ data) != key || data == 0) return false;
+
+        out = unpack(data);
+        return out.bound != Bound::NONE;
+    }
+
+    void TranspositionTable::store(uint64_t key, const Entry& entry) {
+        Slot& slot = slots[key & mask];
+        uint64_t data = pack(entry);
+        slot.data.store(data, memory_order_relaxed);
+        slot.check.store(key ^ data, memory_order_relaxed);
+    }
+
+    void TranspositionTable::clear() {
+        for (uint64_t i = 0; i <= mask; i++) {
+            slots[i].data.store(0, memory_order_relaxed);
+            slots[i].check.store(0, memory_order_relaxed);
+        }
+    }
+
+    TranspositionTable& TranspositionTable::endgame() {
+        static TranspositionTable table(20);
+        return table;
+    }
+
+}
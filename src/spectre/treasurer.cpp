@@ -1,27 +1,353 @@
 #include "../../include/spectre/treasurer.h"
 #include "../../include/spectre/vanguard.h" // [FIX] Required for MoveCandidate
 #include "../../include/engine/types.h"     // [FIX] Required for Tile
+#include "../../include/engine/zobrist.h"
+#include "../../include/heuristics.h"
+#include <algorithm>
 #include <vector>
 #include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
 namespace spectre {
 
-    // PHASE 1 LOBOTOMY:
-    // These functions are stripped of complex MPT math to stop the CPU starvation.
-    // They return neutral/zero values to let the bot play purely based on score for now.
+    // --- SUPERLEAVE TABLE ---
 
-    // Header Signature: static double calculateVolatility(const std::vector<char>& tiles);
-    double Treasurer::calculateVolatility(const std::vector<char>& tiles) {
-        return 0.0;
+    // The mapped table (read-only after loading, shared by all threads)
+    static const float* leaveTable = nullptr;
+    static once_flag leaveTableOnce;
+#ifdef _WIN32
+    static vector<float> leaveTableStorage;
+#endif
+
+    static bool mapLeaveTable(const string& path) {
+        ifstream in(path, ios::binary);
+        if (!in) return false;
+
+        Leaves::LeaveTableHeader header{};
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || memcmp(header.magic, "SLV1", 4) != 0 ||
+            header.maxTiles != Leaves::MAX_TILES || header.entryCount != Leaves::LEAVE_TABLE_SIZE) {
+            cout << "[TREASURER] Ignoring " << path << ": not a superleave table." << endl;
+            return false;
+        }
+
+        size_t bytes = sizeof(header) + sizeof(float) * static_cast<size_t>(Leaves::LEAVE_TABLE_SIZE);
+
+#ifdef _WIN32
+        leaveTableStorage.resize(Leaves::LEAVE_TABLE_SIZE);
+        in.read(reinterpret_cast<char*>(leaveTableStorage.data()), leaveTableStorage.size() * sizeof(float));
+        if (!in) return false;
+        leaveTable = leaveTableStorage.data();
+#else
+        in.close();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < bytes) {
+            close(fd);
+            return false;
+        }
+
+        void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd); // the mapping stays valid
+        if (mapped == MAP_FAILED) return false;
+
+        leaveTable = reinterpret_cast<const float*>(static_cast<const char*>(mapped) + sizeof(header));
+#endif
+
+        cout << "[TREASURER] Superleaves mapped from " << path << " ("
+             << Leaves::LEAVE_TABLE_SIZE << " leaves)." << endl;
+        return true;
+    }
+
+    bool Treasurer::loadLeaveTable(const std::string& filename) {
+        call_once(leaveTableOnce, [&]() {
+            // Same search path as the dictionary
+            const string prefixes[] = {"", "data/", "../data/", "../../data/", "../../../data/"};
+            for (const auto& prefix : prefixes) {
+                if (mapLeaveTable(prefix + filename)) break;
+            }
+        });
+        return leaveTable != nullptr;
+    }
+
+    bool Treasurer::hasLeaveTable() {
+        return loadLeaveTable("superleaves.bin");
+    }
+
+    float Treasurer::leaveValue(const int* counts) {
+        if (hasLeaveTable()) {
+            int64_t idx = Leaves::indexOf(counts);
+            if (idx >= 0) return leaveTable[idx];
+        }
+
+        // Fallback: sum of per-letter values
+        float value = 0.0f;
+        for (int i = 0; i < Leaves::SLOTS; i++) {
+            if (counts[i] == 0) continue;
+            char letter = (i == 26) ? '?' : static_cast<char>('A' + i);
+            value += counts[i] * Heuristics::getLeaveValue(letter);
+        }
+        return value;
+    }
+
+    float Treasurer::leaveValue(const char* leave) {
+        int counts[Leaves::SLOTS] = {0};
+        for (int i = 0; leave[i] != '\0'; i++) {
+            int slot = TileRack::slotOf(leave[i]);
+            if (slot >= 0) counts[slot]++;
+        }
+        return leaveValue(counts);
+    }
+
+    float Treasurer::turnLeaveValue(const int* counts) {
+        const Heuristics::LeaveWeights& w = Heuristics::turnWeights();
+        float value = leaveValue(counts) * w.scale;
+        for (int i = 0; i < Leaves::SLOTS; i++) {
+            if (counts[i] > 0 && counts[i] < Heuristics::LeaveWeights::MAX_COPIES) value += w.adjust[i][counts[i]];
+        }
+        return value;
+    }
+
+    float Treasurer::turnLeaveValue(const char* leave) {
+        int counts[Leaves::SLOTS] = {0};
+        for (int i = 0; leave[i] != '\0'; i++) {
+            int slot = TileRack::slotOf(leave[i]);
+            if (slot >= 0) counts[slot]++;
+        }
+        return turnLeaveValue(counts);
+    }
+
+    bool Treasurer::writeLeaveTable(const std::string& filename, const std::vector<float>& values) {
+        if (values.size() != Leaves::LEAVE_TABLE_SIZE) return false;
+
+        // Written aside and renamed into place, so a process that still has the
+        // old table mapped keeps reading the old file instead of a truncated one.
+        string tmpName = filename + ".tmp";
+        {
+            ofstream out(tmpName, ios::binary | ios::trunc);
+            if (!out) return false;
+
+            Leaves::LeaveTableHeader header{};
+            memcpy(header.magic, "SLV1", 4);
+            header.maxTiles = Leaves::MAX_TILES;
+            header.entryCount = Leaves::LEAVE_TABLE_SIZE;
+
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+            if (!out.good()) return false;
+        }
+
+        error_code ec;
+        filesystem::rename(tmpName, filename, ec);
+        return !ec;
+    }
+
+    // --- EXPECTED DRAW ---
+
+    static const int RACK_SIZE = 7;
+    static const int S_SLOT = 'S' - 'A';
+    static const int Q_SLOT = 'Q' - 'A';
+    static const int U_SLOT = 'U' - 'A';
+    static const int BLANK_SLOT = 26;
+
+    static const double BALANCE_WEIGHT = 1.5;     // per (vowels off the ideal)^2
+    static const double DUPLICATE_PENALTY = 3.0;  // per extra copy (S and blanks excepted)
+    static const double QU_PENALTY = 8.0;         // Q with no U or blank to play it
+    static const double MAX_GAMMA = 0.5;          // Volatility weight at a 100+ point lead
+
+    static bool isVowelSlot(int slot) {
+        return slot == 0 || slot == 4 || slot == 8 || slot == 14 || slot == 20; // A E I O U
+    }
+
+    // Number of distinct multisets of 'draws' tiles the pool can produce
+    static double countDrawMultisets(const int* unseen, int draws) {
+        double ways[RACK_SIZE + 1] = {1.0};
+        for (int slot = 0; slot < Leaves::SLOTS; slot++) {
+            for (int j = draws; j > 0; j--) {
+                for (int k = 1; k <= unseen[slot] && k <= j; k++) ways[j] += ways[j - k];
+            }
+        }
+        return ways[draws];
+    }
+
+    // Per-thread memo, valid for one pool (one turn)
+    struct DrawMemo {
+        uint64_t poolHash = 0;
+        unordered_map<uint32_t, Treasurer::DrawOutlook> entries;
+    };
+
+    double Treasurer::getFundamentalValue(char tile, int bagSize) {
+        // A tile is worth less when few turns are left to use it
+        double scale = min(1.0, max(0, bagSize) / static_cast<double>(Heuristics::LEAVE_FULL_BAG));
+        return Heuristics::getLeaveValue(tile) * scale;
+    }
+
+    double Treasurer::calculateSynergy(const int* counts) {
+        int size = 0, vowels = 0;
+        double synergy = 0.0;
+
+        for (int i = 0; i < Leaves::SLOTS; i++) {
+            size += counts[i];
+            if (isVowelSlot(i)) vowels += counts[i];
+            if (counts[i] > 1 && i != S_SLOT && i != BLANK_SLOT) synergy -= DUPLICATE_PENALTY * (counts[i] - 1);
+        }
+        if (size == 0) return 0.0;
+
+        // About 3 vowels in 7 tiles; blanks can fill a vowel shortage
+        double off = vowels - size * 3.0 / RACK_SIZE;
+        if (off < 0) off = min(0.0, off + counts[BLANK_SLOT]);
+        synergy -= BALANCE_WEIGHT * off * off;
+
+        if (counts[Q_SLOT] > 0 && counts[U_SLOT] == 0 && counts[BLANK_SLOT] == 0) synergy -= QU_PENALTY;
+        return synergy;
+    }
+
+    double Treasurer::getGamma(int scoreDiff) {
+        // Ahead: prefer steady racks. Behind: volatility is an asset.
+        return max(-MAX_GAMMA, min(MAX_GAMMA, scoreDiff / 100.0 * MAX_GAMMA));
+    }
+
+    Treasurer::DrawOutlook Treasurer::drawOutlook(const int* leave, const int* unseen, int bagSize) {
+        int leaveSize = 0, poolSize = 0;
+        for (int i = 0; i < Leaves::SLOTS; i++) {
+            leaveSize += leave[i];
+            poolSize += unseen[i];
+        }
+        int draws = max(0, min({RACK_SIZE - leaveSize, bagSize, poolSize}));
+
+        if (draws == 0) return DrawOutlook{calculateSynergy(leave), 0.0};
+
+        thread_local DrawMemo memo;
+        uint64_t poolHash = Zobrist::poolKey(unseen) ^ (static_cast<uint64_t>(bagSize) * 0x9E3779B97F4A7C15ULL);
+        if (memo.poolHash != poolHash) {
+            memo.entries.clear();
+            memo.poolHash = poolHash;
+        }
+
+        int64_t index = Leaves::indexOf(leave);
+        if (index >= 0) {
+            auto it = memo.entries.find(static_cast<uint32_t>(index));
+            if (it != memo.entries.end()) return it->second;
+        }
+
+        double value[Leaves::SLOTS];
+        for (int i = 0; i < Leaves::SLOTS; i++) {
+            value[i] = getFundamentalValue(i == BLANK_SLOT ? '?' : static_cast<char>('A' + i), bagSize);
+        }
+
+        // Weighted moments of the rack quality over the draws
+        double sumW = 0.0, sumQ = 0.0, sumQ2 = 0.0;
+
+        if (countDrawMultisets(unseen, draws) <= EXACT_DRAW_LIMIT) {
+            // Exact: each multiset weighs prod C(unseen_i, k_i) (multivariate hypergeometric)
+            int rack[Leaves::SLOTS];
+            memcpy(rack, leave, sizeof(rack));
+
+            auto enumerate = [&](auto&& self, int slot, int left, double weight, double drawn) -> void {
+                if (left == 0) {
+                    double q = drawn + calculateSynergy(rack);
+                    sumW += weight;
+                    sumQ += weight * q;
+                    sumQ2 += weight * q * q;
+                    return;
+                }
+                if (slot == Leaves::SLOTS) return;
+
+                for (int k = 0; k <= unseen[slot] && k <= left; k++) {
+                    rack[slot] += k;
+                    self(self, slot + 1, left - k, weight * Leaves::binomial(unseen[slot], k), drawn + k * value[slot]);
+                    rack[slot] -= k;
+                }
+            };
+            enumerate(enumerate, 0, draws, 1.0, 0.0);
+        } else {
+            // Stratified on the first tile drawn: every letter of the pool gets its
+            // share of the samples, the rest of the draw is sampled without replacement.
+            uint64_t rng = poolHash ^ (static_cast<uint64_t>(index + 1) * 0xBF58476D1CE4E5B9ULL);
+
+            for (int first = 0; first < Leaves::SLOTS; first++) {
+                if (unseen[first] == 0) continue;
+
+                double p = static_cast<double>(unseen[first]) / poolSize;
+                int samples = max(1, static_cast<int>(DRAW_SAMPLES * p + 0.5));
+                double m = 0.0, m2 = 0.0;
+
+                for (int n = 0; n < samples; n++) {
+                    int pool[Leaves::SLOTS];
+                    int rack[Leaves::SLOTS];
+                    memcpy(pool, unseen, sizeof(pool));
+                    memcpy(rack, leave, sizeof(rack));
+
+                    pool[first]--;
+                    rack[first]++;
+                    int left = poolSize - 1;
+                    double drawn = value[first];
+
+                    for (int t = 1; t < draws; t++) {
+                        int r = static_cast<int>((Zobrist::nextKey(rng) >> 32) * static_cast<uint64_t>(left) >> 32);
+                        int slot = 0;
+                        while (r >= pool[slot]) r -= pool[slot++];
+                        pool[slot]--;
+                        rack[slot]++;
+                        left--;
+                        drawn += value[slot];
+                    }
+
+                    double q = drawn + calculateSynergy(rack);
+                    m += q;
+                    m2 += q * q;
+                }
+
+                sumW += p;
+                sumQ += p * m / samples;
+                sumQ2 += p * m2 / samples;
+            }
+        }
+
+        DrawOutlook outlook{0.0, 0.0};
+        if (sumW > 0.0) {
+            outlook.expected = sumQ / sumW;
+            outlook.volatility = sqrt(max(0.0, sumQ2 / sumW - outlook.expected * outlook.expected));
+        }
+
+        if (index >= 0) memo.entries.emplace(static_cast<uint32_t>(index), outlook);
+        return outlook;
+    }
+
+    double Treasurer::calculateVolatility(const int* leave, const int* unseen, int bagSize) {
+        return drawOutlook(leave, unseen, bagSize).volatility;
+    }
+
+    double Treasurer::drawEquity(const int* leave, const int* unseen, int bagSize, int scoreDiff) {
+        DrawOutlook outlook = drawOutlook(leave, unseen, bagSize);
+        return outlook.expected - calculateSynergy(leave) - getGamma(scoreDiff) * outlook.volatility;
     }
 
     // Header Signature: static double evaluateEquity(const std::vector<Tile>& leave, int scoreDiff, int bagSize);
     double Treasurer::evaluateEquity(const std::vector<Tile>& leave, int scoreDiff, int bagSize) {
-        // Return 0.0 equity for now.
-        // This effectively disables the "Paranoia Tax" until we implement Supersuperleaves.
-        return 0.0;
+        // Superleave value of the kept tiles (no risk adjustment yet)
+        int counts[Leaves::SLOTS] = {0};
+        for (const Tile& t : leave) {
+            int slot = TileRack::slotOf(t.letter);
+            if (slot >= 0) counts[slot]++;
+        }
+        return leaveValue(counts);
     }
 
     // Header Signature: static bool approve(const MoveCandidate& move, const std::vector<Tile>& currentRack, float riskAversion);
@@ -35,7 +361,4 @@ namespace spectre {
         return 0.0;
     }
 
-    // Internal helpers (getGamma, getFundamentalValue) are no longer needed
-    // since evaluateEquity is stubbed out.
-
 }
\ No newline at end of file
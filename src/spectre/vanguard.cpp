@@ -3,104 +3,510 @@
 #include "../../include/engine/mechanics.h"
 #include "../../include/spectre/logger.h"
 #include "../../include/spectre/treasurer.h"
+#include "../../include/spectre/danger_map.h"
+#include "../../include/spectre/thread_pool.h"
+#include "../../include/spectre/win_model.h"
 #include "../../include/heuristics.h"
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
+#include <random>
 
 using namespace std;
 
 namespace spectre {
 
-// --- HELPER: Danger Check ---
-// Returns TRUE if the move places a tile adjacent to an empty TWS
-bool leavesTWSOpen(const MoveCandidate& move, const LetterBoard& board) {
-    int r = move.row;
-    int c = move.col;
-    int dr = move.isHorizontal ? 0 : 1;
-    int dc = move.isHorizontal ? 1 : 0;
-
-    // Iterate through the word being placed
-    for (int i=0; move.word[i] != '\0'; i++) {
-        // Check 4 neighbors of the current tile
-        int nr[] = {r+1, r-1, r, r};
-        int nc[] = {c, c, c+1, c-1};
-
-        for(int k=0; k<4; k++) {
-            int checkR = nr[k];
-            int checkC = nc[k];
-
-            // Bounds check
-            if (checkR >= 0 && checkR < 15 && checkC >= 0 && checkC < 15) {
-                // Is this neighbor a TWS? (0,0), (0,7), (0,14), (7,0), (7,14), (14,0), (14,7), (14,14)
-                bool isTWS = ((checkR==0 || checkR==7 || checkR==14) && (checkC==0 || checkC==7 || checkC==14) && !(checkR==7 && checkC==7));
-
-                // If it IS a TWS and it is EMPTY (and not being filled by this move)
-                if (isTWS && board[checkR][checkC] == ' ') {
-                    return true; // DANGER: We just put a tile next to an open TWS
-                }
-            }
-        }
-        r += dr; c += dc;
-    }
-    return false;
-}
-
 // --- MAIN SEARCH ---
 
     MoveCandidate Vanguard::search(const LetterBoard& board,
-                                   const Board& bonusBoard,
                                    const TileRack& rack,
                                    Spy& spy,
                                    Dictionary& dict,
                                    int timeLimitMs,
                                    int bagSize,
+                                   int scoreDiff,
+                                   SearchTier tier)
+{
+    SearchControl control = SearchControl::withBudget(timeLimitMs);
+    return search(board, rack, spy, dict, control, bagSize, scoreDiff, tier);
+}
+
+    MoveCandidate Vanguard::search(const LetterBoard& board,
+                                   const TileRack& rack,
+                                   Spy& spy,
+                                   Dictionary& dict,
+                                   SearchControl& control,
+                                   int bagSize,
                                    int scoreDiff, // (MyScore - OppScore)
-                                   OpponentType oppType)
+                                   SearchTier tier)
 {
+    // Leave weights are per thread and this may run on AnytimeSearch's own: build them here
+    Heuristics::updateWeights(spy.getUnseenCounts(), bagSize);
+
     vector<MoveCandidate> candidates = MoveGenerator::generate(board, rack, dict, false);
 
     if (candidates.empty()) {
         MoveCandidate pass; pass.word[0] = '\0'; return pass;
     }
 
-    MoveCandidate bestMove;
-    bestMove.score = -10000;
-    bestMove.word[0] = '\0';
-
     // PANIC MODE CHECK
-    // If we are losing by > 40 points, disable defense. We need to catch up.
-    bool panicMode = (scoreDiff < -40);
+    // If we are unlikely to win from here, disable defense. We need to catch up.
+    bool panicMode = WinModel::winProbability(scoreDiff, spy.getUnseenTotal(), true) < PANIC_WIN_PROB;
 
+    // Refill outlook needs something left to draw (memoized per leave inside Treasurer)
+    const int* drawPool = (bagSize > 0 && spy.getUnseenTotal() > 0) ? spy.getUnseenCounts() : nullptr;
+
+    // 1. STATIC PASS (cheap one-pass equity for every move)
     for (auto& cand : candidates) {
 
         // A. Base Score
-        int logicScore = Mechanics::calculateTrueScore(cand, board, bonusBoard);
+        int logicScore = Mechanics::calculateTrueScore(cand, board);
+
+        // B. Rack Equity (Keep Good Tiles, and what they will draw)
+        int leaveCounts[Leaves::SLOTS] = {0};
+        for (int i = 0; cand.leave[i] != '\0'; i++) {
+            int slot = TileRack::slotOf(cand.leave[i]);
+            if (slot >= 0) leaveCounts[slot]++;
+        }
+        // turnLeaveValue values the kept tiles; drawEquity adds only what the draw changes
+        float leaveVal = Treasurer::turnLeaveValue(leaveCounts);
+        if (drawPool) leaveVal += (float)Treasurer::drawEquity(leaveCounts, drawPool, bagSize, scoreDiff);
+
+        cand.score = logicScore + (int)leaveVal;
+    }
+
+    // C. Danger: what each move opens, read off a map built once for this board.
+    // It only orders the moves (the lookahead measures the real reply for the top
+    // ones); .score keeps the static equity. Skipped in panic mode.
+    if (panicMode) {
+        sort(candidates.begin(), candidates.end(),
+            [](const MoveCandidate& a, const MoveCandidate& b) { return a.score > b.score; });
+    } else {
+        DangerMap danger;
+        danger.build(board);
+
+        vector<pair<float, int>> ranked(candidates.size());
+        for (size_t i = 0; i < candidates.size(); i++) {
+            int threat = danger.threatOf(danger.maskOf(candidates[i], board));
+            ranked[i] = {candidates[i].score - DANGER_WEIGHT * threat, static_cast<int>(i)};
+        }
+        stable_sort(ranked.begin(), ranked.end(),
+            [](const pair<float, int>& a, const pair<float, int>& b) { return a.first > b.first; });
 
-        // B. Rack Equity (Keep Good Tiles)
-        float leaveVal = 0.0f;
-        for(char c : cand.leave) {
-            if(c == '\0') break;
-            leaveVal += Heuristics::getLeaveValue(c);
+        vector<MoveCandidate> ordered;
+        ordered.reserve(candidates.size());
+        for (const auto& entry : ranked) ordered.push_back(candidates[entry.second]);
+        candidates.swap(ordered);
+    }
+
+    // The static best is the first answer an anytime caller can use
+    SearchProgress progress;
+    progress.best = candidates[0];
+    progress.hasMove = true;
+    progress.value = candidates[0].score;
+    control.report(progress);
+
+    // Nothing to look at: no time, nothing left to draw, or a forced move
+    if (control.shouldStop() || tier == SearchTier::STATIC || bagSize == 0 ||
+        candidates.size() == 1 || spy.getUnseenTotal() == 0) {
+        return candidates[0];
+    }
+
+    // 2. LOOKAHEAD: re-rank the top moves by equity minus the opponent's best reply
+    // (the measured threat of what each move opens). Skipped in panic mode.
+    // .score keeps the static equity (callers compare it against fixed thresholds).
+    if (!panicMode) {
+        size_t n = min(candidates.size(), static_cast<size_t>(LOOKAHEAD_CANDIDATES));
+        vector<MoveCandidate> top(candidates.begin(), candidates.begin() + n);
+        vector<double> threat = lookahead(board, spy, dict, top, control);
+
+        // A cut-short pass has unmeasured moves: keep the static order then
+        if (!control.shouldStop()) {
+            vector<int> order(n);
+            for (size_t i = 0; i < n; i++) order[i] = static_cast<int>(i);
+            stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                return top[a].score - threat[a] > top[b].score - threat[b];
+            });
+            for (size_t i = 0; i < n; i++) candidates[i] = top[order[i]];
+
+            progress.best = candidates[0];
+            progress.value = candidates[0].score - threat[order[0]];
+            control.report(progress);
+
+            ScopedLogger log;
+            std::cout << "[VANGUARD] Lookahead: " << candidates[0].word << " " << candidates[0].score
+                      << " - reply " << threat[order[0]] << std::endl;
         }
+    }
+
+    if (control.shouldStop() || tier == SearchTier::LOOKAHEAD) return candidates[0];
+
+    // 3. SIMULATION (top N moves)
+    if (candidates.size() > SIM_CANDIDATES) candidates.resize(SIM_CANDIDATES);
+
+    vector<SimResult> results = simulate(board, rack, spy, dict, candidates, scoreDiff, control);
+
+    // Best surviving move (eliminated ones are worse with 95% confidence)
+    const SimResult* best = nullptr;
+    int totalIterations = 0;
+    int survivors = 0;
+    for (const auto& r : results) {
+        totalIterations += r.iterations;
+        if (r.eliminated || r.iterations == 0) continue;
+        survivors++;
+        if (!best || r.beats(*best)) best = &r;
+    }
+    if (!best) return candidates[0];
+
+    {
+        ScopedLogger log;
+        std::cout << "[VANGUARD] " << totalIterations << " playouts over " << results.size()
+                  << " moves, " << survivors << " left. Best: " << best->move.word << " " << best->mean
+                  << " [" << best->ciLow() << ", " << best->ciHigh() << "], win "
+                  << static_cast<int>(best->winRate * 100.0 + 0.5) << "%" << std::endl;
+    }
+
+    // Keep the static equity in .score (callers compare it against fixed thresholds)
+    return best->move;
+}
+
+// --- LOOKAHEAD ---
+
+    vector<double> Vanguard::lookahead(const LetterBoard& board,
+                                       const Spy& spy,
+                                       Dictionary& dict,
+                                       const vector<MoveCandidate>& candidates,
+                                       SearchControl& control)
+{
+    int n = static_cast<int>(candidates.size());
+    vector<double> threat(n, 0.0);
+    if (n == 0 || spy.getUnseenTotal() == 0) return threat;
+
+    // A. Opponent racks: Spy-weighted, topped up from the rest of the unseen pool
+    const int* unseen = spy.getUnseenCounts();
+    mt19937_64 rng(random_device{}());
+    int racks[LOOKAHEAD_RACKS][27];
+
+    for (int k = 0; k < LOOKAHEAD_RACKS; k++) {
+        int pool27[27];
+        for (int i = 0; i < 27; i++) pool27[i] = unseen[i];
+
+        int* oppRack = racks[k];
+        for (int i = 0; i < 27; i++) oppRack[i] = 0;
+        int oppSize = 0;
+        int sampled[27];
+        spy.sampleRack(sampled);
+        for (int slot = 0; slot < 27; slot++) {
+            int take = min(min(sampled[slot], pool27[slot]), 7 - oppSize);
+            pool27[slot] -= take;
+            oppRack[slot] += take;
+            oppSize += take;
+        }
+
+        TileBag bag;
+        for (int i = 0; i < 27; i++) bag.add(i == 26 ? '?' : static_cast<char>('A' + i), pool27[i]);
+        bag.seed(rng());
+        fillRack(oppRack, bag);
+    }
+
+    // B. One candidate per job: make, best reply per rack, unmake
+    ThreadPool& pool = ThreadPool::instance();
+    atomic<int> next{0};
+
+    pool.parallelFor(min(pool.size(), n), [&](int) {
+        LetterBoard work = board;
+        BoardConstraints constraints;
+        int rackCounts[27];
+
+        while (!control.shouldStop()) {
+            int ci = next.fetch_add(1, memory_order_relaxed);
+            if (ci >= n) break;
+            const MoveCandidate& move = candidates[ci];
+
+            // Make (blanks are already lowercase in the generated word)
+            uint8_t placed[BOARD_SIZE];
+            int placedCount = 0;
+            int r = move.row, c = move.col;
+            int dr = move.isHorizontal ? 0 : 1;
+            int dc = move.isHorizontal ? 1 : 0;
+            for (int i = 0; move.word[i] != '\0' && r < BOARD_SIZE && c < BOARD_SIZE; i++) {
+                if (work[r][c] == ' ') {
+                    work[r][c] = move.word[i];
+                    placed[placedCount++] = static_cast<uint8_t>(r * BOARD_SIZE + c);
+                }
+                r += dr; c += dc;
+            }
 
-        // C. Tower Defense
-        int penalty = 0;
+            constraints.build(work);
 
-        // Only apply penalty if opponent is Greedy AND we are NOT panicking.
-        if (oppType == OpponentType::GREEDY && !panicMode) {
-            if (leavesTWSOpen(cand, board)) {
-                penalty = 25;
+            double total = 0.0;
+            for (int k = 0; k < LOOKAHEAD_RACKS; k++) {
+                int bestReply = 0;
+                auto topOne = [&](MoveCandidate& reply, int*) -> bool {
+                    int s = calculateScore(work, reply);
+                    if (s > bestReply) bestReply = s;
+                    return true;
+                };
+                memcpy(rackCounts, racks[k], sizeof(rackCounts));
+                MoveGenerator::generate_prepared(work, constraints, rackCounts, dict, topOne);
+                total += bestReply;
             }
+            threat[ci] = total / LOOKAHEAD_RACKS;
+
+            // Unmake
+            for (int i = 0; i < placedCount; i++) work[placed[i] / BOARD_SIZE][placed[i] % BOARD_SIZE] = ' ';
         }
+    });
+
+    return threat;
+}
+
+// --- SIMULATION ---
+
+    vector<SimResult> Vanguard::simulate(const LetterBoard& board,
+                                         const TileRack& rack,
+                                         const Spy& spy,
+                                         Dictionary& dict,
+                                         const vector<MoveCandidate>& candidates,
+                                         int scoreDiff,
+                                         SearchControl& control,
+                                         int plies)
+{
+    int n = static_cast<int>(candidates.size());
+    vector<SimResult> results(n);
+    if (n == 0) return results;
+
+    // Root data shared (read-only) by all workers
+    int rootRack[27] = {0};
+    rack.fillCounts(rootRack);
+
+    vector<int> baseScores(n);
+    for (int i = 0; i < n; i++) {
+        results[i].move = candidates[i];
+        results[i].staticEquity = candidates[i].score;
+        baseScores[i] = calculateScore(board, candidates[i]);
+    }
+
+    const int* unseen = spy.getUnseenCounts();
+
+    // Per-worker accumulators (sums and sums of squares of equity and win
+    // probability, count), merged after every round
+    struct Stat { double sum = 0.0; double sumSq = 0.0; double win = 0.0; double winSq = 0.0; int count = 0; };
+    ThreadPool& pool = ThreadPool::instance();
+    int workers = pool.size();
+    vector<vector<Stat>> stats(workers, vector<Stat>(n));
+
+    uint64_t baseSeed = random_device{}();
+    vector<mt19937_64> rngs;
+    for (int w = 0; w < workers; w++) rngs.emplace_back(baseSeed + 0x9E3779B97F4A7C15ULL * (w + 1));
+
+    // One playout of candidate 'ci', recorded in worker 'w's accumulators
+    auto runPlayout = [&](int w, int ci) {
+        mt19937_64& rng = rngs[w];
+
+        // A. Opponent rack from the Spy, bag = rest of the unseen pool
+        int pool27[27];
+        for (int i = 0; i < 27; i++) pool27[i] = unseen[i];
+
+        int oppRack[27] = {0};
+        int oppSize = 0;
+        int sampled[27];
+        spy.sampleRack(sampled);
+        for (int slot = 0; slot < 27; slot++) {
+            int take = min(min(sampled[slot], pool27[slot]), 7 - oppSize);
+            pool27[slot] -= take;
+            oppRack[slot] += take;
+            oppSize += take;
+        }
+
+        TileBag bag;
+        for (int i = 0; i < 27; i++) bag.add(i == 26 ? '?' : static_cast<char>('A' + i), pool27[i]);
+        bag.seed(rng());
+        fillRack(oppRack, bag);
 
-        cand.score = logicScore + (int)leaveVal - penalty;
+        // B. Our candidate, then draw
+        LetterBoard simBoard = board;
+        int myRack[27];
+        for (int i = 0; i < 27; i++) myRack[i] = rootRack[i];
+        applyMove(simBoard, candidates[ci], myRack);
+        fillRack(myRack, bag);
 
-        if (cand.score > bestMove.score) {
-            bestMove = cand;
+        // C. Play it out
+        int equity = baseScores[ci] + playout(simBoard, myRack, oppRack, bag, plies, dict);
+
+        // Where the game stands afterwards: we are on move after an odd number of replies
+        int oppTiles = 0;
+        for (int i = 0; i < 27; i++) oppTiles += oppRack[i];
+        double win = WinModel::winProbability(scoreDiff + equity, bag.size() + oppTiles, plies % 2 == 1);
+
+        Stat& s = stats[w][ci];
+        s.sum += equity;
+        s.sumSq += static_cast<double>(equity) * equity;
+        s.win += win;
+        s.winSq += win * win;
+        s.count++;
+    };
+
+    // Merge the worker accumulators into the results
+    auto collect = [&]() {
+        for (int i = 0; i < n; i++) {
+            double sum = 0.0, sumSq = 0.0, win = 0.0, winSq = 0.0;
+            int count = 0;
+            for (int w = 0; w < workers; w++) {
+                sum += stats[w][i].sum;
+                sumSq += stats[w][i].sumSq;
+                win += stats[w][i].win;
+                winSq += stats[w][i].winSq;
+                count += stats[w][i].count;
+            }
+
+            SimResult& r = results[i];
+            r.iterations = count;
+            if (count == 0) continue;
+
+            r.mean = sum / count;
+            r.winRate = win / count;
+            if (count > 1) {
+                double variance = (sumSq - sum * r.mean) / (count - 1);
+                r.stdErr = sqrt(max(0.0, variance) / count);
+                double winVariance = (winSq - win * r.winRate) / (count - 1);
+                r.winStdErr = sqrt(max(0.0, winVariance) / count);
+            }
+        }
+    };
+
+    // RACING: play in rounds, only over the moves still alive. After each round,
+    // drop every move whose upper confidence bound on win probability is below
+    // the leader's lower bound, so the budget goes to the moves that could still win.
+    vector<int> alive(n);
+    for (int i = 0; i < n; i++) alive[i] = i;
+
+    while (alive.size() > 1 && !control.shouldStop()) {
+        int roundSize = static_cast<int>(alive.size()) * SIM_ROUND_PLAYOUTS;
+        atomic<int> nextIteration{0};
+
+        pool.parallelFor(workers, [&](int w) {
+            while (!control.shouldStop()) {
+                int it = nextIteration.fetch_add(1, memory_order_relaxed);
+                if (it >= roundSize) break;
+                runPlayout(w, alive[it % alive.size()]);
+            }
+        });
+
+        collect();
+
+        int leader = alive[0];
+        for (int i : alive) if (results[i].beats(results[leader])) leader = i;
+
+        bool capped = true;
+        bool lost = true;
+        vector<int> survivors;
+        for (int i : alive) {
+            const SimResult& r = results[i];
+            if (r.winCiHigh() > 1.0 - WinModel::DECIDED) lost = false;
+            if (i != leader && r.iterations >= SIM_MIN_PLAYOUTS && r.winCiHigh() < results[leader].winCiLow()) {
+                results[i].eliminated = true;
+                continue;
+            }
+            survivors.push_back(i);
+            if (r.iterations < SIM_MAX_ITERATIONS) capped = false;
         }
+        alive.swap(survivors);
+
+        // Best-so-far for anytime callers
+        SearchProgress progress;
+        progress.best = results[leader].move;
+        progress.hasMove = true;
+        progress.value = results[leader].mean;
+        for (const auto& r : results) progress.iterations += r.iterations;
+        control.report(progress);
+
+        if (capped) break;
+
+        // Decided either way: more playouts will not change the result
+        bool won = results[leader].iterations >= SIM_MIN_PLAYOUTS && results[leader].winCiLow() >= WinModel::DECIDED;
+        if (won || (lost && results[leader].iterations >= SIM_MIN_PLAYOUTS)) break;
+    }
+
+    return results;
+}
+
+int Vanguard::playout(LetterBoard& board,
+                      int* myRackCounts, int* oppRackCounts,
+                      TileBag& bag, int plies, Dictionary& dict) {
+    int spread = 0;
+
+    for (int ply = 0; ply < plies; ply++) {
+        bool oppToMove = (ply % 2 == 0);
+        int* rackCounts = oppToMove ? oppRackCounts : myRackCounts;
+
+        // Greedy reply: highest scoring move for this rack
+        MoveCandidate best;
+        best.word[0] = '\0';
+        int bestScore = -1;
+
+        auto greedyConsumer = [&](MoveCandidate& cand, int* /*remaining*/) -> bool {
+            int s = calculateScore(board, cand);
+            if (s > bestScore) {
+                bestScore = s;
+                best = cand;
+            }
+            return true;
+        };
+        MoveGenerator::generate_raw(board, rackCounts, dict, greedyConsumer);
+
+        if (bestScore < 0) continue; // No move: pass
+
+        applyMove(board, best, rackCounts);
+        fillRack(rackCounts, bag);
+        spread += oppToMove ? -bestScore : bestScore;
+    }
+
+    // What we keep for later
+    float leaveVal = Treasurer::leaveValue(myRackCounts);
+
+    return spread + static_cast<int>(leaveVal);
+}
+
+int Vanguard::calculateScore(const LetterBoard& board, const MoveCandidate& move) {
+    return Mechanics::calculateTrueScore(move, board);
+}
+
+int Vanguard::applyMove(LetterBoard& board, const MoveCandidate& move, int* rackCounts) {
+    int r = move.row;
+    int c = move.col;
+    int dr = move.isHorizontal ? 0 : 1;
+    int dc = move.isHorizontal ? 1 : 0;
+    int placed = 0;
+
+    for (int i = 0; move.word[i] != '\0'; i++) {
+        if (board[r][c] == ' ') {
+            char letter = move.word[i];
+            if (letter >= 'a' && letter <= 'z') {
+                if (rackCounts[26] > 0) rackCounts[26]--;
+            } else {
+                int idx = letter - 'A';
+                if (rackCounts[idx] > 0) rackCounts[idx]--;
+                else if (rackCounts[26] > 0) { rackCounts[26]--; letter = static_cast<char>(tolower(letter)); }
+            }
+            board[r][c] = letter;
+            placed++;
+        }
+        r += dr; c += dc;
     }
+    return placed;
+}
+
+void Vanguard::fillRack(int* rackCounts, TileBag& bag) {
+    int size = 0;
+    for (int i = 0; i < 27; i++) size += rackCounts[i];
 
-    return bestMove;
+    while (size < 7 && !bag.empty()) {
+        Tile t = bag.draw();
+        rackCounts[TileRack::slotOf(t.letter)]++;
+        size++;
+    }
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,140 @@
+#include "../../include/spectre/win_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+using namespace std;
+
+namespace spectre {
+
+    // Built-in model: remaining spread ~ Normal(on-move edge, sigma(unseen))
+    static const double SIGMA_PER_SQRT_TILE = 7.5;  // ~70 points of swing from a full bag
+    static const double ON_MOVE_POINTS = 8.0;       // Worth of having the next turn
+
+    static uint16_t winTable[WinModel::TABLE_SIZE];
+    static once_flag winTableOnce;
+
+    static uint16_t toCell(double p) {
+        return static_cast<uint16_t>(lround(min(1.0, max(0.0, p)) * 65535.0));
+    }
+
+    static bool readWinTable(const string& path) {
+        ifstream in(path, ios::binary);
+        if (!in) return false;
+
+        WinModel::WinTableHeader header{};
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || memcmp(header.magic, "WPT1", 4) != 0 ||
+            header.spreadBins != WinModel::SPREAD_BINS || header.unseenBins != WinModel::UNSEEN_BINS) {
+            cout << "[WINMODEL] Ignoring " << path << ": not a win table." << endl;
+            return false;
+        }
+
+        in.read(reinterpret_cast<char*>(winTable), sizeof(winTable));
+        if (!in) return false;
+
+        cout << "[WINMODEL] Win probabilities loaded from " << path << "." << endl;
+        return true;
+    }
+
+    double WinModel::priorProbability(int onMove, int unseenBin, int spreadBin) {
+        int unseen = unseenBin * UNSEEN_STEP;
+        double spread = SPREAD_MIN + spreadBin * SPREAD_STEP;
+        if (onMove) spread += ON_MOVE_POINTS * min(1.0, unseen / 7.0);
+
+        double sigma = SIGMA_PER_SQRT_TILE * sqrt(static_cast<double>(unseen));
+        if (sigma < 1e-9) return (spread > 0) ? 1.0 : (spread < 0 ? 0.0 : 0.5);
+        return 0.5 * erfc(-spread / (sigma * sqrt(2.0)));
+    }
+
+    bool WinModel::load(const string& filename) {
+        bool loaded = false;
+        call_once(winTableOnce, [&]() {
+            // Same search path as the dictionary
+            const string prefixes[] = {"", "data/", "../data/", "../../data/", "../../../data/"};
+            for (const auto& prefix : prefixes) {
+                if (readWinTable(prefix + filename)) {
+                    loaded = true;
+                    return;
+                }
+            }
+
+            for (int side = 0; side < 2; side++) {
+                for (int u = 0; u < UNSEEN_BINS; u++) {
+                    for (int s = 0; s < SPREAD_BINS; s++) {
+                        winTable[cellIndex(side, u, s)] = toCell(priorProbability(side, u, s));
+                    }
+                }
+            }
+        });
+        return loaded;
+    }
+
+    bool WinModel::write(const string& filename, const vector<uint16_t>& table) {
+        if (table.size() != TABLE_SIZE) return false;
+
+        string tmpName = filename + ".tmp";
+        {
+            ofstream out(tmpName, ios::binary | ios::trunc);
+            if (!out) return false;
+
+            WinTableHeader header{};
+            memcpy(header.magic, "WPT1", 4);
+            header.spreadBins = SPREAD_BINS;
+            header.unseenBins = UNSEEN_BINS;
+
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(uint16_t));
+            if (!out.good()) return false;
+        }
+
+        error_code ec;
+        filesystem::rename(tmpName, filename, ec);
+        return !ec;
+    }
+
+    int WinModel::spreadBin(int spread) {
+        int bin = static_cast<int>(lround(static_cast<double>(spread - SPREAD_MIN) / SPREAD_STEP));
+        return max(0, min(SPREAD_BINS - 1, bin));
+    }
+
+    int WinModel::unseenBin(int unseenTiles) {
+        int bin = static_cast<int>(lround(static_cast<double>(unseenTiles) / UNSEEN_STEP));
+        return max(0, min(UNSEEN_BINS - 1, bin));
+    }
+
+    float WinModel::winProbability(int spread, int unseenTiles, bool onMove) {
+        load("winprob.bin");
+
+        // Fractional cell coordinates, clamped to the table
+        double s = static_cast<double>(spread - SPREAD_MIN) / SPREAD_STEP;
+        double u = static_cast<double>(unseenTiles) / UNSEEN_STEP;
+        s = max(0.0, min(static_cast<double>(SPREAD_BINS - 1), s));
+        u = max(0.0, min(static_cast<double>(UNSEEN_BINS - 1), u));
+
+        int s0 = min(static_cast<int>(s), SPREAD_BINS - 2);
+        int u0 = min(static_cast<int>(u), UNSEEN_BINS - 2);
+        double fs = s - s0;
+        double fu = u - u0;
+
+        int side = onMove ? 1 : 0;
+        double p00 = winTable[cellIndex(side, u0, s0)];
+        double p01 = winTable[cellIndex(side, u0, s0 + 1)];
+        double p10 = winTable[cellIndex(side, u0 + 1, s0)];
+        double p11 = winTable[cellIndex(side, u0 + 1, s0 + 1)];
+
+        double p = (1 - fu) * ((1 - fs) * p00 + fs * p01) + fu * ((1 - fs) * p10 + fs * p11);
+        return static_cast<float>(p / 65535.0);
+    }
+
+    bool WinModel::isDecided(int spread, int unseenTiles, bool onMove) {
+        float p = winProbability(spread, unseenTiles, onMove);
+        return p >= DECIDED || p <= 1.0f - DECIDED;
+    }
+
+}
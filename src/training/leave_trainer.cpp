@@ -0,0 +1,410 @@
+#include "../../include/training/sample_log.h"
+#include "../../include/engine/board.h"
+#include "../../include/engine/dictionary.h"
+#include "../../include/engine/game_director.h"
+#include "../../include/engine/zobrist.h"
+#include "../../include/ai_player.h"
+#include "../../include/heuristics.h"
+#include "../../include/spectre/treasurer.h"
+#include "../../include/spectre/thread_pool.h"
+#include "../../include/spectre/win_model.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace spectre;
+
+// ================================================================
+//                 LEAVE TRAINER (SELF-PLAY)
+// ================================================================
+// Plays Speedi_Pi against itself on every core, logs what each player kept
+// and how the game went from there, then fits one value per leave and writes
+// the superleave table read by Treasurer. Every decision is also logged as a
+// position (spread, unseen tiles, side to move, result) for the WinModel table.
+//
+// Usage: leaveTrainer [--games N] [--log FILE] [--out FILE] [--win-log FILE]
+//                     [--win-out FILE] [--dict FILE] [--fit-only]
+// --games is the total for the leave log: a rerun (or a run after Ctrl+C) only
+// plays the games still missing, then refits from every sample in the logs.
+
+static const int FLUSH_SAMPLES = 1 << 15;   // Samples buffered before a log write
+static const double PRIOR_WEIGHT = 20.0;    // Pseudo-samples pulling rare leaves to the static values
+static const double WIN_PRIOR_WEIGHT = 10.0; // Pseudo-games pulling sparse win cells to the built-in model
+
+static atomic<bool> stopRequested(false);
+
+static void onInterrupt(int) {
+    stopRequested = true;
+}
+
+// --- RECORDING ---
+
+// Samples of one game. A sample is opened when a player commits to a move and
+// closed at the next decision point, when the move (and its draw) is on the board.
+struct GameRecord {
+    struct Sample {
+        uint32_t leave;
+        int seat;
+        int spreadAfter;   // Mover's spread right after the move
+    };
+
+    // A decision point, from one player's side
+    struct Position {
+        int seat;
+        int spread;
+        int unseen;
+        bool onMove;
+    };
+
+    vector<Sample> samples;
+    vector<Position> positions;
+    bool open = false;
+    Sample pending{};
+    uint64_t rackKeyBefore = 0;
+
+    // Both players' view of the position the mover faces
+    void observe(const GameState& state, int seat) {
+        for (int p = 0; p < 2; p++) {
+            int spread = state.players[p].score - state.players[1 - p].score;
+            positions.push_back(Position{p, spread, state.unseenFor(p).total, p == seat});
+        }
+    }
+
+    void begin(const GameState& state, int seat, const Move& move) {
+        open = false;
+        // Endgame leaves are never refilled, they say nothing about the rack
+        if (state.bag.empty()) return;
+        if (move.type != MoveType::PLAY && move.type != MoveType::EXCHANGE) return;
+
+        const TileRack& rack = state.players[seat].rack;
+        int counts[Leaves::SLOTS];
+        rack.fillCounts(counts);
+
+        // Same tile choice as Mechanics: exact tile first, then a blank
+        const string& used = (move.type == MoveType::PLAY) ? move.word : move.exchangeLetters;
+        for (char letter : used) {
+            int slot = TileRack::slotOf(letter);
+            if (slot < 0) continue;
+            if (counts[slot] > 0) counts[slot]--;
+            else if (counts[Leaves::SLOTS - 1] > 0) counts[Leaves::SLOTS - 1]--;
+            else return; // Not from this rack: the Referee will reject it
+        }
+
+        int64_t index = Leaves::indexOf(counts);
+        if (index < 0) return;
+
+        pending.leave = static_cast<uint32_t>(index);
+        pending.seat = seat;
+        rackKeyBefore = Zobrist::rackKey(seat, rack);
+        open = true;
+    }
+
+    void close(const GameState& state) {
+        if (!open) return;
+        open = false;
+
+        // A rejected move leaves the rack untouched: nothing was kept
+        int seat = pending.seat;
+        if (Zobrist::rackKey(seat, state.players[seat].rack) == rackKeyBefore) return;
+
+        pending.spreadAfter = state.players[seat].score - state.players[1 - seat].score;
+        samples.push_back(pending);
+    }
+};
+
+// Passes every call through to the real player and records its decisions
+class RecordingPlayer : public PlayerController {
+public:
+    RecordingPlayer(PlayerController& inner, int seat, GameRecord& record)
+        : inner(inner), seat(seat), record(record) {}
+
+    Move getMove(const GameState& state, const Board& bonusBoard,
+                 const LastMoveInfo& lastMove, bool canChallenge) override {
+        record.close(state);
+        record.observe(state, seat);
+        Move move = inner.getMove(state, bonusBoard, lastMove, canChallenge);
+        record.begin(state, seat, move);
+        return move;
+    }
+
+    Move getEndGameResponse(const GameState& state, const LastMoveInfo& lastMove) override {
+        record.close(state);
+        return inner.getEndGameResponse(state, lastMove);
+    }
+
+    string getName() const override { return inner.getName(); }
+
+    void observeMove(const Move& move, const LetterBoard& preMoveBoard, const BlankBoard& preMoveBlanks) override {
+        inner.observeMove(move, preMoveBoard, preMoveBlanks);
+    }
+
+private:
+    PlayerController& inner;
+    int seat;
+    GameRecord& record;
+};
+
+// --- SELF-PLAY ---
+
+static bool playGames(Training::SampleLog& log, Training::SampleLog& winLog, uint64_t targetGames) {
+    if (log.games() >= targetGames) return true;
+
+    uint64_t remaining = targetGames - log.games();
+    ThreadPool& pool = ThreadPool::instance();
+    int workers = pool.size();
+
+    cout << "[TRAINER] Playing " << remaining << " games on " << workers << " threads ("
+         << log.games() << " already logged)." << endl;
+
+    atomic<uint64_t> nextGame(0);
+    mutex logMutex;
+    vector<uint32_t> buffer;
+    vector<uint32_t> winBuffer;
+    uint64_t bufferGames = 0;
+    bool writeFailed = false;
+    auto start = chrono::steady_clock::now();
+
+    // Caller holds logMutex
+    auto flush = [&]() {
+        if (bufferGames == 0) return;
+        if (!log.append(buffer, bufferGames)) writeFailed = true;
+        if (!winLog.append(winBuffer, bufferGames)) writeFailed = true;
+        buffer.clear();
+        winBuffer.clear();
+        bufferGames = 0;
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "[TRAINER] " << log.games() << "/" << targetGames << " games, "
+             << log.samples() << " samples";
+        if (seconds > 0) cout << " (" << static_cast<int>(nextGame.load() / seconds) << " games/s)";
+        cout << endl;
+    };
+
+    pool.parallelFor(workers, [&](int) {
+        AIPlayer bots[2] = {AIPlayer(AIStyle::SPEEDI_PI), AIPlayer(AIStyle::SPEEDI_PI)};
+        Board bonusBoard = createBoard();
+
+        GameDirector::Config cfg;
+        cfg.verbose = false;
+        cfg.allowChallenge = false;
+
+        vector<uint32_t> packed;
+        vector<uint32_t> packedPositions;
+
+        while (!stopRequested) {
+            uint64_t game = nextGame.fetch_add(1);
+            if (game >= remaining) break;
+
+            GameRecord record;
+            RecordingPlayer p1(bots[0], 0, record);
+            RecordingPlayer p2(bots[1], 1, record);
+            GameDirector director(&p1, &p2, bonusBoard, cfg);
+            MatchResult result = director.run(static_cast<int>(game + 1));
+
+            // Target: how much the mover still gained on the opponent after keeping this leave
+            int finalSpread[2] = {result.scoreP1 - result.scoreP2, result.scoreP2 - result.scoreP1};
+            packed.clear();
+            for (const auto& s : record.samples) {
+                packed.push_back(Training::packSample(s.leave, finalSpread[s.seat] - s.spreadAfter));
+            }
+
+            packedPositions.clear();
+            for (const auto& p : record.positions) {
+                int outcome = (result.winner == -1) ? 1 : (result.winner == p.seat ? 2 : 0);
+                packedPositions.push_back(Training::packPosition(p.spread, p.unseen, p.onMove, outcome));
+            }
+
+            lock_guard<mutex> lock(logMutex);
+            buffer.insert(buffer.end(), packed.begin(), packed.end());
+            winBuffer.insert(winBuffer.end(), packedPositions.begin(), packedPositions.end());
+            bufferGames++;
+            if (buffer.size() >= FLUSH_SAMPLES) flush();
+        }
+    });
+
+    lock_guard<mutex> lock(logMutex);
+    flush();
+    if (writeFailed) cerr << "[TRAINER] Writing the sample log failed." << endl;
+    return !writeFailed;
+}
+
+// --- FITTING ---
+
+// Calls visit(counts, tiles) for every leave of up to MAX_TILES tiles
+template <typename Visit>
+static void forEachLeave(int* counts, int slot, int tilesLeft, int tiles, Visit&& visit) {
+    if (slot == Leaves::SLOTS) {
+        visit(counts, tiles);
+        return;
+    }
+    for (int n = 0; n <= tilesLeft; n++) {
+        counts[slot] = n;
+        forEachLeave(counts, slot + 1, tilesLeft - n, tiles + n, visit);
+    }
+    counts[slot] = 0;
+}
+
+// Leave value = mean future spread of the leave minus the mean of all samples,
+// shrunk towards the static per-letter values when a leave was rarely seen.
+static bool fitLeaves(Training::SampleLog& log, const string& outFile) {
+    if (log.samples() == 0) {
+        cerr << "[TRAINER] No samples to fit." << endl;
+        return false;
+    }
+
+    vector<double> sums(Leaves::LEAVE_TABLE_SIZE, 0.0);
+    vector<uint32_t> hits(Leaves::LEAVE_TABLE_SIZE, 0);
+    double total = 0.0;
+
+    bool ok = log.forEach([&](uint32_t sample) {
+        uint32_t index = Training::sampleLeave(sample);
+        if (index >= Leaves::LEAVE_TABLE_SIZE) return;
+        int spread = Training::sampleSpread(sample);
+        sums[index] += spread;
+        hits[index]++;
+        total += spread;
+    });
+    if (!ok) {
+        cerr << "[TRAINER] Reading the sample log failed." << endl;
+        return false;
+    }
+
+    double mean = total / static_cast<double>(log.samples());
+    vector<float> values(Leaves::LEAVE_TABLE_SIZE, 0.0f);
+    int seenLeaves = 0;
+
+    int counts[Leaves::SLOTS] = {0};
+    forEachLeave(counts, 0, Leaves::MAX_TILES, 0, [&](const int* leave, int) {
+        int64_t index = Leaves::indexOf(leave);
+
+        double prior = 0.0;
+        for (int i = 0; i < Leaves::SLOTS; i++) {
+            if (leave[i] == 0) continue;
+            char letter = (i == Leaves::SLOTS - 1) ? '?' : static_cast<char>('A' + i);
+            prior += leave[i] * Heuristics::getLeaveValue(letter);
+        }
+
+        double n = hits[index];
+        if (n > 0) seenLeaves++;
+        values[index] = static_cast<float>((sums[index] - n * mean + PRIOR_WEIGHT * prior) / (n + PRIOR_WEIGHT));
+    });
+
+    cout << "[TRAINER] Fitted " << seenLeaves << "/" << Leaves::LEAVE_TABLE_SIZE << " leaves from "
+         << log.samples() << " samples (mean future spread " << mean << ")." << endl;
+
+    if (!Treasurer::writeLeaveTable(outFile, values)) {
+        cerr << "[TRAINER] Could not write " << outFile << endl;
+        return false;
+    }
+    cout << "[TRAINER] Superleaves written to " << outFile << endl;
+    return true;
+}
+
+// Win rate of each table cell (draws = half), shrunk towards the built-in model
+static bool fitWinTable(Training::SampleLog& log, const string& outFile) {
+    if (log.samples() == 0) {
+        cerr << "[TRAINER] No positions to fit." << endl;
+        return false;
+    }
+
+    vector<double> wins(WinModel::TABLE_SIZE, 0.0);
+    vector<double> games(WinModel::TABLE_SIZE, 0.0);
+
+    bool ok = log.forEach([&](uint32_t sample) {
+        int cell = WinModel::cellIndex(Training::positionOnMove(sample) ? 1 : 0,
+                                       WinModel::unseenBin(Training::positionUnseen(sample)),
+                                       WinModel::spreadBin(Training::positionSpread(sample)));
+        wins[cell] += 0.5 * Training::positionResult(sample);
+        games[cell] += 1.0;
+    });
+    if (!ok) {
+        cerr << "[TRAINER] Reading the win log failed." << endl;
+        return false;
+    }
+
+    vector<uint16_t> table(WinModel::TABLE_SIZE);
+    for (int side = 0; side < 2; side++) {
+        for (int u = 0; u < WinModel::UNSEEN_BINS; u++) {
+            for (int s = 0; s < WinModel::SPREAD_BINS; s++) {
+                int cell = WinModel::cellIndex(side, u, s);
+                double prior = WinModel::priorProbability(side, u, s);
+                double p = (wins[cell] + WIN_PRIOR_WEIGHT * prior) / (games[cell] + WIN_PRIOR_WEIGHT);
+                table[cell] = static_cast<uint16_t>(p * 65535.0 + 0.5);
+            }
+        }
+    }
+
+    if (!WinModel::write(outFile, table)) {
+        cerr << "[TRAINER] Could not write " << outFile << endl;
+        return false;
+    }
+    cout << "[TRAINER] Win table written to " << outFile << " (" << log.samples() << " positions)." << endl;
+    return true;
+}
+
+// --- ENTRY POINT ---
+
+int main(int argc, char** argv) {
+    uint64_t games = 10000;
+    string logFile = "leave_samples.slog";
+    string outFile = "superleaves.bin";
+    string winLogFile = "win_samples.wlog";
+    string winOutFile = "winprob.bin";
+    string dictFile = "csw24.txt";
+    bool fitOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--games" && hasValue) games = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--log" && hasValue) logFile = argv[++i];
+        else if (arg == "--out" && hasValue) outFile = argv[++i];
+        else if (arg == "--win-log" && hasValue) winLogFile = argv[++i];
+        else if (arg == "--win-out" && hasValue) winOutFile = argv[++i];
+        else if (arg == "--dict" && hasValue) dictFile = argv[++i];
+        else if (arg == "--fit-only") fitOnly = true;
+        else {
+            cerr << "Usage: " << argv[0]
+                 << " [--games N] [--log FILE] [--out FILE] [--win-log FILE] [--win-out FILE]"
+                 << " [--dict FILE] [--fit-only]" << endl;
+            return 1;
+        }
+    }
+
+    Training::SampleLog log;
+    if (!log.open(logFile, "SLOG")) {
+        cerr << "[TRAINER] " << logFile << " is not a leave sample log." << endl;
+        return 1;
+    }
+    Training::SampleLog winLog;
+    if (!winLog.open(winLogFile, "WLOG")) {
+        cerr << "[TRAINER] " << winLogFile << " is not a win sample log." << endl;
+        return 1;
+    }
+
+    if (!fitOnly) {
+        if (!gDictionary.loadFromFile(dictFile)) {
+            cerr << "ERROR: A valid Dictionary isn't found!" << endl;
+            return 1;
+        }
+
+        // Play with the current table (if any), so each run refines the last one
+        Treasurer::loadLeaveTable(outFile);
+
+        signal(SIGINT, onInterrupt);
+        if (!playGames(log, winLog, games)) return 1;
+        if (stopRequested) cout << "[TRAINER] Interrupted, rerun to finish the remaining games." << endl;
+    }
+
+    bool leavesOk = fitLeaves(log, outFile);
+    bool winOk = fitWinTable(winLog, winOutFile);
+    return (leavesOk && winOk) ? 0 : 1;
+}
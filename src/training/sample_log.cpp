@@ -0,0 +1,58 @@
+#include "../../include/training/sample_log.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace Training {
+
+    static constexpr uint32_t LOG_VERSION = 1;
+
+    bool SampleLog::open(const string& filename, const char* magic) {
+        file.open(filename, ios::in | ios::out | ios::binary);
+
+        if (!file.is_open()) {
+            // New log: write an empty header first
+            ofstream create(filename, ios::binary);
+            if (!create) return false;
+            create.close();
+
+            file.open(filename, ios::in | ios::out | ios::binary);
+            if (!file.is_open()) return false;
+
+            memcpy(header.magic, magic, 4);
+            header.version = LOG_VERSION;
+            header.games = 0;
+            header.samples = 0;
+            return writeHeader();
+        }
+
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || memcmp(header.magic, magic, 4) != 0 || header.version != LOG_VERSION) {
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool SampleLog::append(const vector<uint32_t>& samples, uint64_t games) {
+        file.clear();
+        file.seekp(sizeof(SampleLogHeader) + header.samples * sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(uint32_t));
+        file.flush();
+        if (!file) return false;
+
+        // Samples first, header second: a crash in between loses the batch, never corrupts the log
+        header.samples += samples.size();
+        header.games += games;
+        return writeHeader();
+    }
+
+    bool SampleLog::writeHeader() {
+        file.clear();
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.flush();
+        return file.good();
+    }
+}